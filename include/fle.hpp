@@ -4,9 +4,11 @@
 #define FLE_HPP
 
 #include "nlohmann/json.hpp"
+#include <algorithm>
 #include <cstdint>
 #include <fstream>
 #include <map>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -18,7 +20,11 @@ enum class RelocationType {
     R_X86_64_PC32, // 32-bit PC-relative addressing
     R_X86_64_64, // 64-bit absolute addressing
     R_X86_64_32S, // 32-bit signed absolute addressing
-    R_X86_64_GOTPCREL // 32-bit PC-relative GOT address
+    R_X86_64_GOTPCREL, // 32-bit PC-relative GOT address
+    R_X86_64_GOTPCRELX, // GOTPCREL the linker may relax to a direct reference (also REX_GOTPCRELX)
+    R_X86_64_IRELATIVE, // 64-bit slot filled with the result of calling the resolver at addend
+    R_X86_64_TPOFF32, // 32-bit offset of a TLS symbol from the thread pointer
+    R_X86_64_GOTTPOFF // 32-bit PC-relative address of a GOT slot holding the TLS offset
 };
 
 // Relocation entry
@@ -44,6 +50,7 @@ struct Symbol {
     size_t offset; // Offset within section
     size_t size; // Symbol size
     std::string name; // Symbol name
+    bool ifunc = false; // GLOBAL symbol at an IFUNC resolver (🔀), see FLE_ld
 };
 
 struct FLESection {
@@ -64,6 +71,9 @@ enum class SHF { // Section Header Flags
     WRITE = 2, // Writable
     EXEC = 4, // Executable
     NOBITS = 8, // Takes no space in file (like BSS)
+    TLS = 16, // Thread-local template data (.tdata/.tbss)
+    MERGE = 32, // Made of entsize-byte entities that may be deduplicated
+    STRINGS = 64, // With MERGE: NUL-terminated strings of entsize-byte characters
 };
 
 // ================= PHF (Program Header Flags) =================
@@ -138,6 +148,8 @@ struct SectionHeader {
     uint64_t addr; // Virtual address
     uint64_t offset; // File offset
     uint64_t size; // Section size
+    uint64_t entsize = 0; // Entity size of SHF::MERGE sections, 0 otherwise
+    uint64_t addralign = 1; // Required alignment (sh_addralign), a power of two
 };
 
 struct ProgramHeader {
@@ -145,6 +157,19 @@ struct ProgramHeader {
     uint64_t vaddr; // Virtual address (64-bit)
     uint64_t size; // Segment size
     uint32_t flags; // Permissions
+    uint64_t offset = 0; // Image offset from the start of the binary payload (binary segment layout)
+    uint64_t filesz = 0; // Bytes backed by the binary image, 0 if the segment has no image
+};
+
+// Static TLS template of an executable, like ELF PT_TLS. The .tdata image lies at
+// vaddr inside the read-only data segment; .tbss follows it in the block and is
+// zero. Each thread's block ends at its thread pointer (%fs), so a TLS symbol at
+// offset off in the block is at %fs - align_up(memsz, align) + off.
+struct TLSHeader {
+    uint64_t vaddr = 0; // Address of the .tdata image
+    uint64_t filesz = 0; // Initialized bytes (.tdata)
+    uint64_t memsz = 0; // Block size including .tbss, 0 if the program has no TLS
+    uint64_t align = 1; // Block alignment
 };
 
 struct FLEObject {
@@ -158,9 +183,27 @@ struct FLEObject {
     size_t entry = 0; // Entry point (for .exe)
 
     std::vector<std::string> needed; // List of shared libraries this object depends on (e.g., "libfoo.so")
+    std::map<std::string, std::vector<std::string>> lazy; // Needed libraries loaded on first call (ld -z lazyload) -> functions bound through the PLT
     std::vector<Relocation> dyn_relocs; // Dynamic relocations
+    TLSHeader tls; // Static TLS template (for .exe)
+
+    uint64_t image_base = 0; // File offset of the binary payload (page aligned), 0 if the file has none
 };
 
+// Binary segment layout: the JSON text is terminated by a NUL byte and followed,
+// from the next page boundary on, by the raw segment images. Each image starts at
+// an offset congruent to its vaddr modulo the page size and the gaps are zero, so
+// the loader can mmap segments straight from the file.
+constexpr uint64_t FLE_IMAGE_ALIGN = 4096;
+
+// Transparent huge page size on x86-64. `ld --huge-text` aligns and pads the text
+// segment to this size so `exec --huge-pages` can back it with 2 MiB pages.
+constexpr uint64_t FLE_HUGE_PAGE_SIZE = 0x200000;
+
+// Alignment of the static TLS block. A cache line keeps per-thread blocks
+// from sharing lines with each other.
+constexpr uint64_t FLE_TLS_ALIGN = 64;
+
 class FLEWriter {
 public:
     void set_type(std::string_view type)
@@ -190,8 +233,33 @@ public:
 
     void write_to_file(const std::string& filename)
     {
-        std::ofstream out(filename);
+        std::ofstream out(filename, std::ios::binary);
         out << result.dump(4) << std::endl;
+        if (images.empty()) {
+            return;
+        }
+
+        out.put('\0');
+        uint64_t payload = (static_cast<uint64_t>(out.tellp()) + FLE_IMAGE_ALIGN - 1) / FLE_IMAGE_ALIGN * FLE_IMAGE_ALIGN;
+        uint64_t end = payload;
+        for (const auto& [offset, data] : images) {
+            out.seekp(payload + offset);
+            out.write(reinterpret_cast<const char*>(data->data()), data->size());
+            end = std::max(end, payload + offset + data->size());
+        }
+        // Pad the last page so every image page is fully backed by the file
+        uint64_t file_end = (end + FLE_IMAGE_ALIGN - 1) / FLE_IMAGE_ALIGN * FLE_IMAGE_ALIGN;
+        if (file_end > end) {
+            out.seekp(file_end - 1);
+            out.put('\0');
+        }
+    }
+
+    // Queue a segment image for the binary payload, offset is relative to its start.
+    // The data is referenced, not copied, and must outlive write_to_file.
+    void add_segment_image(uint64_t offset, const std::vector<uint8_t>& data)
+    {
+        images.emplace_back(offset, &data);
     }
 
     void write_program_headers(const std::vector<ProgramHeader>& phdrs)
@@ -203,6 +271,10 @@ public:
             phdr_json["vaddr"] = phdr.vaddr;
             phdr_json["size"] = phdr.size;
             phdr_json["flags"] = phdr.flags;
+            if (phdr.filesz != 0) {
+                phdr_json["offset"] = phdr.offset;
+                phdr_json["filesz"] = phdr.filesz;
+            }
             phdrs_json.push_back(phdr_json);
         }
         result["phdrs"] = phdrs_json;
@@ -224,6 +296,12 @@ public:
             shdr_json["addr"] = shdr.addr;
             shdr_json["offset"] = shdr.offset;
             shdr_json["size"] = shdr.size;
+            if (shdr.entsize != 0) {
+                shdr_json["entsize"] = shdr.entsize;
+            }
+            if (shdr.addralign > 1) {
+                shdr_json["addralign"] = shdr.addralign;
+            }
             shdrs_json.push_back(shdr_json);
         }
         result["shdrs"] = shdrs_json;
@@ -234,10 +312,26 @@ public:
         result["needed"] = needed;
     }
 
+    void write_lazy(const std::map<std::string, std::vector<std::string>>& lazy)
+    {
+        result["lazy"] = lazy;
+    }
+
+    void write_tls(const TLSHeader& tls)
+    {
+        result["tls"] = {
+            { "vaddr", tls.vaddr },
+            { "filesz", tls.filesz },
+            { "memsz", tls.memsz },
+            { "align", tls.align },
+        };
+    }
+
 private:
     std::string current_section;
     json result;
     std::vector<std::string> current_lines;
+    std::vector<std::pair<uint64_t, const std::vector<uint8_t>*>> images;
 };
 
 /**
@@ -286,18 +380,44 @@ void FLE_objdump(const FLEObject& obj, FLEWriter& writer);
  */
 void FLE_nm(const FLEObject& obj);
 
+struct ExecOptions {
+    std::string program_path; // 可执行文件路径 (用于快照缓存的校验)
+    int fork_server_fd = -1; // 控制 socket (--fork-server)，-1 表示直接运行
+    std::string snapshot_dir; // 重定位后镜像的缓存目录 (--snapshot-cache)，为空表示关闭
+    bool huge_pages = false; // 用 2 MiB 透明大页映射代码段 (--huge-pages)
+    unsigned jobs = 0; // 并行解析、映射与重定位的线程数 (-j, --jobs)，0 表示按 CPU 核数
+    std::string profile_path; // 采样分析结果 (--profile)，同时写出 .folded 折叠栈，为空表示关闭
+    bool count_plt = false; // 经 GOT 调用的导入函数插入计数跳板，退出时输出各符号调用次数 (--count-plt)
+};
+
 /**
  * Execute an FLE executable file
  * @param obj The FLE executable object
+ * @param options Loader configuration options
  * @throws runtime_error if the file is not executable or _start symbol is not found
  */
-void FLE_exec(const FLEObject& obj);
+void FLE_exec(FLEObject obj, const ExecOptions& options = {});
 
 struct LinkerOptions {
     std::string outputFile = "a.out"; // 输出文件名 (用于设置 .so 的 name 属性)
     bool shared = false; // 是否生成共享库 (-shared)
     std::string entryPoint = "_start"; // 入口点名称 (默认为 _start)
     bool is_static = false; // 是否强制静态链接 (-static)
+    bool binary_segments = false; // 附加页对齐的二进制段镜像，供加载器直接 mmap (--binary-segments)
+    bool huge_text = false; // 代码段按 2 MiB 对齐并填充，便于使用大页 (--huge-text)
+    std::set<std::string> lazy_libs; // 延迟加载的共享库名 (-z lazyload 之后出现的 .so)
+    bool gc_sections = false; // 丢弃从入口不可达的节 (--gc-sections)
+    bool print_gc_sections = false; // 在标准错误列出被丢弃的节 (--print-gc-sections)
+    std::string icf = "none"; // 相同代码折叠：none、all 或只折叠地址未被使用的函数的 safe (--icf)
+    bool print_icf_sections = false; // 在标准错误列出被折叠的节 (--print-icf-sections)
+    std::vector<std::string> symbol_ordering; // 按此顺序排在代码段最前面的符号 (--symbol-ordering-file)
+    bool call_graph_sort = false; // 按调用图用 C3 启发式排列代码节 (--call-graph-sort)
+    std::map<std::pair<std::string, std::string>, uint64_t> call_graph_profile; // 调用者、被调用者 -> 采样数 (--call-graph-profile)
+    std::vector<std::string> text_order = { "hot", "normal", "startup", "unlikely" }; // 代码节各组的排列顺序 (--text-order)
+    std::vector<std::string> data_order = { "relro", "normal" }; // .data.rel.ro 与其余数据节的排列顺序 (--data-order)
+    bool pack_segments = false; // .got 紧跟 .data、.bss 紧跟 .got，可读写段共用页 (--pack-segments)
+    bool separate_code = true; // 代码段独占页；关闭后 .rodata 紧跟代码并与之共用可读可执行页 (-z noseparate-code)
+    bool print_stats = false; // 在标准错误输出各链接阶段的耗时与 PLT/GOT 数量 (--stats)
 };
 
 /**
@@ -66,6 +66,11 @@ inline bool starts_with(std::string_view s, std::string_view prefix)
     return s.find(prefix) == 0;
 }
 
+inline bool ends_with(std::string_view s, std::string_view suffix)
+{
+    return s.size() >= suffix.size() && s.substr(s.size() - suffix.size()) == suffix;
+}
+
 // 检查字符串是否包含子串
 inline constexpr bool str_contains(std::string_view str, std::string_view sub)
 {
@@ -51,8 +51,10 @@ constexpr auto RELOCATION_FORMATS = std::array {
     std::pair { "R_X86_64_32"sv, RelocationFormat { ".abs"sv, 4 } },
     std::pair { "R_X86_64_32S"sv, RelocationFormat { ".abs32s"sv, 4 } },
     std::pair { "R_X86_64_GOTPCREL"sv, RelocationFormat { ".gotpcrel"sv, 4 } },
-    std::pair { "R_X86_64_GOTPCRELX"sv, RelocationFormat { ".gotpcrel"sv, 4 } },
-    std::pair { "R_X86_64_REX_GOTPCRELX"sv, RelocationFormat { ".gotpcrel"sv, 4 } }
+    std::pair { "R_X86_64_GOTPCRELX"sv, RelocationFormat { ".gotpcrelx"sv, 4 } },
+    std::pair { "R_X86_64_REX_GOTPCRELX"sv, RelocationFormat { ".gotpcrelx"sv, 4 } },
+    std::pair { "R_X86_64_TPOFF32"sv, RelocationFormat { ".tpoff"sv, 4 } },
+    std::pair { "R_X86_64_GOTTPOFF"sv, RelocationFormat { ".gottpoff"sv, 4 } }
 };
 
 // 解析符号表
@@ -89,6 +91,9 @@ std::string format_symbol_line(const Symbol& sym)
     case 'l':
         return fmt::format("🏷️: {} {} {}", sym.name, sym.size, sym.offset);
     case 'g':
+        // 类型为 i 的是 GNU 间接函数（IFUNC），偏移指向解析函数
+        if (sym.type == "i")
+            return fmt::format("🔀: {} {} {}", sym.name, sym.size, sym.offset);
         return fmt::format("📤: {} {} {}", sym.name, sym.size, sym.offset);
     case 'w':
         return fmt::format("📎: {} {} {}", sym.name, sym.size, sym.offset);
@@ -101,8 +106,9 @@ std::string format_symbol_line(const Symbol& sym)
 std::map<int, std::pair<int, std::string>> parse_relocations(
     const std::string& binary, std::string_view section)
 {
+    // 指向 IFUNC 的重定位，readelf 在符号值一栏显示为 "name()"
     static const std::regex reloc_pattern {
-        R"(^\s*([0-9a-fA-F]+)\s+([0-9a-fA-F]+)\s+(\S+)\s+([0-9a-fA-F]+)\s+(.*)$)"
+        R"(^\s*([0-9a-fA-F]+)\s+([0-9a-fA-F]+)\s+(\S+)\s+([0-9a-fA-F]+|\S+\(\))\s+(.*)$)"
     };
 
     std::map<int, std::pair<int, std::string>> relocations;
@@ -143,6 +149,32 @@ std::map<int, std::pair<int, std::string>> parse_relocations(
     return relocations;
 }
 
+// 可合并节的属性（objdump -h 不显示 MERGE/STRINGS 标志和项大小）
+struct MergeInfo {
+    bool strings;
+    uint64_t entsize;
+};
+
+// 解析 readelf 的节头表，取出带 M 标志的节
+std::map<std::string, MergeInfo> parse_merge_sections(const std::string& binary)
+{
+    static const std::regex section_pattern {
+        R"(^\s*\[\s*\d+\]\s+(\S+)\s+\S+\s+[0-9a-fA-F]+\s+[0-9a-fA-F]+\s+[0-9a-fA-F]+\s+([0-9a-fA-F]+)\s+([A-Za-z]*)\s+\d+\s+\d+\s+\d+\s*$)"
+    };
+
+    std::map<std::string, MergeInfo> merge_sections;
+    for (const auto& line : splitlines(execute_command(fmt::format("readelf -SW {}", binary)))) {
+        if (std::smatch match; std::regex_match(line, match, section_pattern)) {
+            const std::string flags = match[3].str();
+            const uint64_t entsize = std::stoull(match[2].str(), nullptr, 16);
+            if (str_contains(flags, "M") && entsize > 0) {
+                merge_sections.emplace(match[1].str(), MergeInfo { str_contains(flags, "S"), entsize });
+            }
+        }
+    }
+    return merge_sections;
+}
+
 std::vector<std::string> elf_to_fle(
     const std::string& binary, std::string_view section, bool is_bss = false)
 {
@@ -259,12 +291,13 @@ void FLE_cc(const std::vector<std::string>& options)
 
     // 解析目标文件
     const auto objdump_output = execute_command(fmt::format("objdump -h {}", binary));
+    const auto merge_sections = parse_merge_sections(binary);
     FLEWriter writer;
     writer.set_type(".obj");
 
-    // 处理每个节
+    // 处理每个节：序号、节名、大小 ... 对齐（2**N）
     static const std::regex section_pattern {
-        R"(^\s*([0-9]+)\s+(\.(\w|\.)+)\s+([0-9a-fA-F]+)\s+.*$)"
+        R"(^\s*([0-9]+)\s+(\.(\w|\.)+)\s+([0-9a-fA-F]+)\s+.*\s2\*\*([0-9]+)\s*$)"
     };
 
     auto lines = splitlines(objdump_output);
@@ -312,6 +345,17 @@ void FLE_cc(const std::vector<std::string>& options)
         if (is_nobits) {
             sh_flags |= SHF::NOBITS;
         }
+        if (contains(flags, "THREAD_LOCAL")) {
+            sh_flags |= SHF::TLS;
+        }
+        uint64_t entsize = 0;
+        if (const auto merge_it = merge_sections.find(section_name); merge_it != merge_sections.end()) {
+            sh_flags |= SHF::MERGE;
+            if (merge_it->second.strings) {
+                sh_flags |= SHF::STRINGS;
+            }
+            entsize = merge_it->second.entsize;
+        }
 
         // 创建节头
         section_headers.push_back(SectionHeader {
@@ -321,6 +365,8 @@ void FLE_cc(const std::vector<std::string>& options)
             .addr = 0,
             .offset = current_offset,
             .size = size,
+            .entsize = entsize,
+            .addralign = uint64_t { 1 } << std::stoul(match[5].str()),
         });
 
         current_offset += size;
@@ -1,48 +1,246 @@
 #include "fle.hpp"
 #include "string_utils.hpp"
+#include <atomic>
 #include <cassert>
+#include <chrono>
+#include <climits>
 #include <cstdint>
+#include <cstdlib>
 #include <cstring>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <functional>
 #include <map>
+#include <mutex>
+#include <sstream>
 #include <stdexcept>
+#include <thread>
+#include <asm/prctl.h>
+#include <csignal>
+#include <fcntl.h>
 #include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/time.h>
+#include <ucontext.h>
+#include <sys/wait.h>
 #include <unistd.h>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
+#ifndef MAP_FIXED_NOREPLACE
+#define MAP_FIXED_NOREPLACE 0x100000
+#endif
+
+// Runtime loading API handed to FLE programs, see "Runtime loading API" below
+extern "C" {
+void* fle_dlopen(const char* name);
+void* fle_dlsym(void* handle, const char* name);
+int fle_dlclose(void* handle);
+const char* fle_dlerror();
+uint64_t fle_lazy_bind(uint64_t index);
+void fle_lazy_trampoline();
+}
+
 namespace {
 
+// Per-module counters reported by FLE_DEBUG=statistics
+struct ModuleStats {
+    size_t dyn_relocs = 0;
+    size_t section_relocs = 0;
+    double dyn_reloc_ms = 0;
+    double section_reloc_ms = 0;
+    uint64_t lookup_hits = 0; // Lookups satisfied by this module
+    uint64_t lookup_misses = 0; // Lookups that searched this module without a match
+};
+
 struct LoadedModule {
     std::string name;
+    std::string path; // File the module was loaded from
     FLEObject obj;
-    uint64_t load_base;
+    uint64_t load_base = 0;
     std::map<std::string, uint64_t> section_addrs;
+    ModuleStats stats;
+    bool dynamic = false; // Loaded by fle_dlopen rather than at startup
+    unsigned dl_refs = 0; // fle_dlopen references held on a dynamic module
+    bool unloaded = false; // Unmapped by fle_dlclose, kept so handles stay stable
+    bool needs_parse = false; // Restored from a snapshot, symbol table not read yet
+    uint64_t loader_api_slot = 0; // Address of __fle_loader_api recorded in the snapshot, 0 if none
 };
 
 // Global list of loaded modules to maintain loading order
 // Order: Main Execution -> Dependency 1 -> Dependency 2 ...
 std::vector<LoadedModule> loaded_modules;
-std::unordered_set<std::string> loaded_module_names;
 
 // Flag: true if any SO has PC32 dyn_relocs (requires all SOs in low address space)
 bool need_low_address = false;
-std::unordered_set<std::string> scanned_names;
 
-// Helper to load FLE from file (searches FLE_LIBRARY_PATH)
-FLEObject load_fle_with_path(const std::string& filename)
+// exec --huge-pages: back 2 MiB aligned text segments with transparent huge pages
+bool use_huge_pages = false;
+
+// ================= Startup statistics (FLE_DEBUG=statistics) =================
+
+// Startup phases. Times are exclusive: a symbol lookup issued while applying
+// relocations is charged to SymbolLookup, not to the relocation phase.
+enum class Phase {
+    DependencyScan,
+    Parse,
+    Mmap,
+    DynRelocs,
+    SectionRelocs,
+    SymbolLookup,
+    Mprotect,
+    Snapshot,
+    Count
+};
+
+constexpr const char* PHASE_NAMES[] = {
+    "dependency scan",
+    "parse",
+    "mmap",
+    "dynamic relocations",
+    "section relocations",
+    "symbol lookups",
+    "mprotect",
+    "snapshot",
+};
+
+struct LoaderStats {
+    bool enabled = false;
+    bool json = false;
+    std::string output; // FLE_DEBUG_OUTPUT, empty means stderr
+    double phase_ms[static_cast<size_t>(Phase::Count)] = {};
+    uint64_t phase_count[static_cast<size_t>(Phase::Count)] = {};
+    size_t vmas_before = 0; // VMAs in the process before and after loading
+    size_t vmas_after = 0;
+    std::chrono::steady_clock::time_point start;
+};
+
+LoaderStats stats;
+
+// Loader phases run on several threads; the shared counters are updated under
+// this lock (only when statistics are enabled)
+std::mutex stats_mutex;
+
+// Parse FLE_DEBUG, a comma separated list of options (like LD_DEBUG).
+// "statistics" enables the startup report, "json" switches it to JSON.
+void init_stats()
 {
-    // Try direct path
-    try {
-        return load_fle(filename);
-    } catch (...) {
+    stats = LoaderStats {};
+    const char* env = std::getenv("FLE_DEBUG");
+    if (env != nullptr) {
+        std::string opts(env);
+        size_t start = 0;
+        while (start <= opts.size()) {
+            size_t end = opts.find(',', start);
+            if (end == std::string::npos)
+                end = opts.size();
+            std::string opt = trim(opts.substr(start, end - start));
+            if (opt == "statistics")
+                stats.enabled = true;
+            else if (opt == "json")
+                stats.json = true;
+            start = end + 1;
+        }
+    }
+    const char* out = std::getenv("FLE_DEBUG_OUTPUT");
+    if (out != nullptr)
+        stats.output = out;
+    stats.start = std::chrono::steady_clock::now();
+}
+
+// RAII timer charging elapsed time to a phase. Nested timers subtract their
+// time from the enclosing one so that phase times add up to the total.
+class PhaseTimer {
+public:
+    explicit PhaseTimer(Phase phase, double* module_ms = nullptr)
+        : phase(phase)
+        , module_ms(module_ms)
+    {
+        if (!stats.enabled)
+            return;
+        parent = current;
+        current = this;
+        begin = std::chrono::steady_clock::now();
     }
 
-    try {
-        return load_fle(filename + ".fle");
-    } catch (...) {
+    ~PhaseTimer()
+    {
+        if (!stats.enabled)
+            return;
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+        double exclusive = ms - child_ms;
+        {
+            std::lock_guard<std::mutex> lock(stats_mutex);
+            stats.phase_ms[static_cast<size_t>(phase)] += exclusive;
+            if (module_ms != nullptr)
+                *module_ms += exclusive;
+        }
+        if (parent != nullptr)
+            parent->child_ms += ms;
+        current = parent;
     }
 
+    PhaseTimer(const PhaseTimer&) = delete;
+    PhaseTimer& operator=(const PhaseTimer&) = delete;
+
+private:
+    static inline thread_local PhaseTimer* current = nullptr;
+
+    Phase phase;
+    double* module_ms;
+    PhaseTimer* parent = nullptr;
+    double child_ms = 0;
+    std::chrono::steady_clock::time_point begin;
+};
+
+inline void count_phase(Phase phase, uint64_t n = 1)
+{
+    if (!stats.enabled)
+        return;
+    std::lock_guard<std::mutex> lock(stats_mutex);
+    stats.phase_count[static_cast<size_t>(phase)] += n;
+}
+
+// Timed wrapper around load_fle, all parsing in the loader goes through here
+FLEObject parse_fle(const std::string& filename)
+{
+    PhaseTimer timer(Phase::Parse);
+    FLEObject obj = load_fle(filename);
+    count_phase(Phase::Parse);
+    return obj;
+}
+
+constexpr uint64_t PAGE_SIZE = 4096;
+
+inline uint64_t page_down(uint64_t x) { return x & ~(PAGE_SIZE - 1); }
+inline uint64_t page_up(uint64_t x) { return (x + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1); }
+
+int phdr_prot(uint32_t flags)
+{
+    return (flags & PHF::R ? PROT_READ : 0)
+        | (flags & PHF::W ? PROT_WRITE : 0)
+        | (flags & PHF::X ? PROT_EXEC : 0);
+}
+
+// Helper to locate an FLE file: direct path, then with ".fle", then FLE_LIBRARY_PATH
+std::string find_fle_path(const std::string& filename)
+{
+    auto exists = [](const std::string& path) {
+        std::error_code ec;
+        return std::filesystem::is_regular_file(path, ec);
+    };
+
+    // Try direct path
+    if (exists(filename))
+        return filename;
+    if (exists(filename + ".fle"))
+        return filename + ".fle";
+
     // Search in FLE_LIBRARY_PATH
     const char* lib_path_env = std::getenv("FLE_LIBRARY_PATH");
     if (lib_path_env != nullptr) {
@@ -66,325 +264,932 @@ FLEObject load_fle_with_path(const std::string& filename)
             paths.push_back(lib_path.substr(start));
 
         for (const auto& path : paths) {
-            try {
-                return load_fle(path + "/" + basename);
-            } catch (...) {
-            }
-            try {
-                return load_fle(path + "/" + filename);
-            } catch (...) {
-            }
+            if (exists(path + "/" + basename))
+                return path + "/" + basename;
+            if (exists(path + "/" + filename))
+                return path + "/" + filename;
         }
     }
     throw std::runtime_error("Could not load: " + filename);
 }
 
-// Pre-scan dependencies to check if any SO has PC32 dyn_relocs
-void scan_dependencies_recursive(const std::string& filename)
+// ================= Parallel loading =================
+
+// Number of loader threads (exec --jobs), 0 means one per hardware thread
+unsigned loader_jobs = 0;
+
+// Run fn(0) .. fn(n - 1) on up to loader_jobs threads, the caller included.
+// Work is handed out one index at a time. If any call throws, the exception
+// of the lowest failing index is rethrown once all workers are done, so
+// errors are reported the same way as in a serial loop.
+void parallel_for(size_t n, const std::function<void(size_t)>& fn)
 {
-    if (scanned_names.count(filename))
+    size_t workers = loader_jobs != 0 ? loader_jobs : std::max(1u, std::thread::hardware_concurrency());
+    workers = std::min(workers, n);
+    if (workers <= 1) {
+        for (size_t i = 0; i < n; i++) {
+            fn(i);
+        }
         return;
+    }
 
-    FLEObject obj;
-    try {
-        obj = load_fle_with_path(filename);
-    } catch (...) {
-        return; // Will fail later during actual load
+    std::atomic<size_t> next { 0 };
+    std::vector<std::exception_ptr> errors(n);
+    auto work = [&]() {
+        for (size_t i = next++; i < n; i = next++) {
+            try {
+                fn(i);
+            } catch (...) {
+                errors[i] = std::current_exception();
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (size_t t = 1; t < workers; t++) {
+        threads.emplace_back(work);
+    }
+    work();
+    for (auto& thread : threads) {
+        thread.join();
     }
+    for (const auto& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
 
-    scanned_names.insert(filename);
+// Phase one of loading: find and parse every module reachable from `roots`
+// that is not already in `loaded`.
+// The graph is walked breadth-first so that each level is parsed in parallel;
+// every module is parsed exactly once. The returned modules are ordered the
+// way the old depth-first loader visited them (the first root, its
+// dependencies, then the second root, ...), which is the global symbol
+// resolution order.
+std::vector<LoadedModule> discover_dependencies(const std::vector<std::string>& roots,
+    const std::unordered_set<std::string>& loaded = {})
+{
+    PhaseTimer timer(Phase::DependencyScan);
+    std::map<std::string, LoadedModule> found;
+    std::vector<std::string> frontier;
+    for (const auto& dep : roots) {
+        if (!loaded.count(dep) && std::find(frontier.begin(), frontier.end(), dep) == frontier.end()) {
+            frontier.push_back(dep);
+        }
+    }
 
-    // Check for PC32 dyn_relocs
-    if (obj.type == ".so") {
-        for (const auto& reloc : obj.dyn_relocs) {
-            if (reloc.type == RelocationType::R_X86_64_PC32) {
-                need_low_address = true;
-                break;
+    while (!frontier.empty()) {
+        count_phase(Phase::DependencyScan, frontier.size());
+        std::vector<LoadedModule> level(frontier.size());
+        parallel_for(frontier.size(), [&](size_t i) {
+            LoadedModule& mod = level[i];
+            mod.name = frontier[i];
+            try {
+                mod.path = find_fle_path(mod.name);
+            } catch (...) {
+                throw std::runtime_error("Could not load dependency: " + mod.name);
+            }
+            mod.obj = parse_fle(mod.path);
+        });
+
+        std::vector<std::string> next;
+        for (auto& mod : level) {
+            // Any PC32 dyn_reloc forces every SO into the low address space
+            if (mod.obj.type == ".so") {
+                for (const auto& reloc : mod.obj.dyn_relocs) {
+                    if (reloc.type == RelocationType::R_X86_64_PC32) {
+                        need_low_address = true;
+                        break;
+                    }
+                }
+            }
+            for (const auto& dep : mod.obj.needed) {
+                if (!found.count(dep) && !loaded.count(dep) && std::find(frontier.begin(), frontier.end(), dep) == frontier.end()
+                    && std::find(next.begin(), next.end(), dep) == next.end()) {
+                    next.push_back(dep);
+                }
             }
         }
+        for (auto& mod : level) {
+            std::string name = mod.name;
+            found.emplace(name, std::move(mod));
+        }
+        frontier = std::move(next);
     }
 
-    // Recurse into dependencies
-    for (const auto& dep : obj.needed) {
-        scan_dependencies_recursive(dep);
+    // Depth-first preorder over the discovered graph
+    std::vector<LoadedModule> ordered;
+    std::unordered_set<std::string> visited;
+    std::function<void(const std::vector<std::string>&)> visit = [&](const std::vector<std::string>& needed) {
+        for (const auto& dep : needed) {
+            if (loaded.count(dep) || !visited.insert(dep).second) {
+                continue;
+            }
+            ordered.push_back(std::move(found.at(dep)));
+            std::vector<std::string> deps = ordered.back().obj.needed;
+            visit(deps);
+        }
+    };
+    visit(roots);
+    return ordered;
+}
+
+// Address of a GLOBAL or WEAK symbol defined by mod, 0 if it has none.
+// For an IFUNC symbol this is the address of its resolver and *ifunc is set.
+uint64_t lookup_in_module(const LoadedModule& mod, const std::string& name, bool* ifunc = nullptr)
+{
+    for (const auto& sym : mod.obj.symbols) {
+        // We search for GLOBAL or WEAK symbols that are defined (not UNDEFINED)
+        if (sym.name == name && (sym.type == SymbolType::GLOBAL || sym.type == SymbolType::WEAK)) {
+            auto it = mod.section_addrs.find(sym.section);
+            if (it != mod.section_addrs.end()) {
+                if (ifunc)
+                    *ifunc = sym.ifunc;
+                return it->second + sym.offset;
+            }
+        }
     }
+    return 0;
 }
 
 // Helper to resolve a symbol across all loaded modules
-uint64_t resolve_symbol(const std::string& name)
+uint64_t resolve_symbol(const std::string& name, bool* ifunc = nullptr)
 {
-    for (const auto& mod : loaded_modules) {
-        for (const auto& sym : mod.obj.symbols) {
-            // We search for GLOBAL or WEAK symbols that are defined (not UNDEFINED)
-            if (sym.name == name && (sym.type == SymbolType::GLOBAL || sym.type == SymbolType::WEAK)) {
-                auto it = mod.section_addrs.find(sym.section);
-                if (it != mod.section_addrs.end()) {
-                    return it->second + sym.offset;
-                }
-            }
+    PhaseTimer timer(Phase::SymbolLookup);
+    count_phase(Phase::SymbolLookup);
+    for (auto& mod : loaded_modules) {
+        uint64_t addr = lookup_in_module(mod, name, ifunc);
+        if (stats.enabled) {
+            std::lock_guard<std::mutex> lock(stats_mutex);
+            (addr != 0 ? mod.stats.lookup_hits : mod.stats.lookup_misses)++;
+        }
+        if (addr != 0) {
+            return addr;
         }
     }
     throw std::runtime_error("Symbol not found: " + name);
 }
 
-void load_module_recursive(const std::string& filename)
+// Open the module file for mapping segment images, -1 if it has none
+int open_image(const LoadedModule& mod)
 {
-    if (loaded_module_names.count(filename)) {
-        return;
-    }
+    if (mod.obj.image_base == 0 || mod.path.empty())
+        return -1;
+    return open(mod.path.c_str(), O_RDONLY | O_CLOEXEC);
+}
 
-    // Load FLE file
-    // Try direct path first, then search in FLE_LIBRARY_PATH
-    FLEObject obj;
-    bool loaded = false;
+// A text segment qualifies for huge pages when it starts on a 2 MiB boundary
+// and spans whole huge pages, which is what `ld --huge-text` produces.
+bool wants_huge_pages(const ProgramHeader& phdr, uint64_t target)
+{
+    return use_huge_pages && (phdr.flags & PHF::X)
+        && target % FLE_HUGE_PAGE_SIZE == 0 && phdr.size % FLE_HUGE_PAGE_SIZE == 0;
+}
 
-    // Try direct path
-    try {
-        obj = load_fle(filename);
-        loaded = true;
-    } catch (...) {
-        // Try with extensions
-        try {
-            obj = load_fle(filename + ".fle");
-            loaded = true;
-        } catch (...) {
-            // Continue to search in library path
+// Page range [start, end) covering all segments of a module, relative to its load base
+struct ModuleSpan {
+    uint64_t start = 0;
+    uint64_t end = 0;
+};
+
+ModuleSpan module_span(const FLEObject& obj)
+{
+    ModuleSpan span { UINT64_MAX, 0 };
+    for (const auto& phdr : obj.phdrs) {
+        if (phdr.size > 0) {
+            span.start = std::min(span.start, page_down(phdr.vaddr));
+            span.end = std::max(span.end, page_up(phdr.vaddr + phdr.size));
         }
     }
+    if (span.end == 0) {
+        span.start = 0;
+    }
+    return span;
+}
 
-    // If not found, search in FLE_LIBRARY_PATH
-    if (!loaded) {
-        const char* lib_path_env = std::getenv("FLE_LIBRARY_PATH");
-        if (lib_path_env != nullptr) {
-            std::string lib_path(lib_path_env);
-            std::string basename = filename;
-            // Extract basename from path if it contains directory separators
-            size_t last_slash = filename.rfind('/');
-            if (last_slash != std::string::npos) {
-                basename = filename.substr(last_slash + 1);
-            }
-
-            // Split FLE_LIBRARY_PATH by ':'
-            std::vector<std::string> paths;
-            size_t start = 0;
-            size_t end = lib_path.find(':');
-            while (end != std::string::npos) {
-                if (end > start) {
-                    paths.push_back(lib_path.substr(start, end - start));
-                }
-                start = end + 1;
-                end = lib_path.find(':', start);
-            }
-            if (start < lib_path.size()) {
-                paths.push_back(lib_path.substr(start));
-            }
+// Map a shared object's whole span as one anonymous RW region and return its
+// load base. In huge page mode the region is over-allocated by one huge page
+// and trimmed so that huge text segments land on a 2 MiB boundary.
+uint64_t reserve_module(const FLEObject& obj, const ModuleSpan& span, int extra_flags)
+{
+    uint64_t size = span.end - span.start;
+    int flags = MAP_PRIVATE | MAP_ANONYMOUS | extra_flags;
 
-            // Try each path
-            for (const auto& path : paths) {
-                std::string full_path = path + "/" + basename;
-                try {
-                    obj = load_fle(full_path);
-                    loaded = true;
-                    break;
-                } catch (...) {
-                    // Try original filename (maybe it's a relative path)
-                    try {
-                        obj = load_fle(path + "/" + filename);
-                        loaded = true;
-                        break;
-                    } catch (...) {
-                        // Continue searching
-                    }
-                }
-            }
+    const ProgramHeader* huge_text = nullptr;
+    for (const auto& phdr : obj.phdrs) {
+        if (wants_huge_pages(phdr, phdr.vaddr)) {
+            huge_text = &phdr;
+            break;
         }
     }
-
-    if (!loaded) {
-        throw std::runtime_error("Could not load dependency: " + filename);
+    if (huge_text == nullptr) {
+        void* addr = mmap(NULL, size, PROT_READ | PROT_WRITE, flags, -1, 0);
+        return addr == MAP_FAILED ? 0 : reinterpret_cast<uint64_t>(addr) - span.start;
     }
 
-    loaded_module_names.insert(filename);
+    uint64_t padded = size + FLE_HUGE_PAGE_SIZE;
+    void* addr = mmap(NULL, padded, PROT_READ | PROT_WRITE, flags, -1, 0);
+    if (addr == MAP_FAILED) {
+        return 0;
+    }
+    uint64_t raw = reinterpret_cast<uint64_t>(addr);
+    uint64_t text = (raw - span.start + huge_text->vaddr + FLE_HUGE_PAGE_SIZE - 1) / FLE_HUGE_PAGE_SIZE * FLE_HUGE_PAGE_SIZE;
+    uint64_t start = text - huge_text->vaddr + span.start;
+    if (start > raw) {
+        munmap(addr, start - raw);
+    }
+    if (raw + padded > start + size) {
+        munmap(reinterpret_cast<void*>(start + size), raw + padded - (start + size));
+    }
+    return start - span.start;
+}
 
-    // Prepare LoadedModule structure
-    LoadedModule mod;
-    mod.name = filename;
-    mod.obj = obj;
+// Fill one segment of a module whose span is already mapped RW.
+// Segments with a binary image are mapped MAP_PRIVATE straight from the file
+// over the anonymous region: pages that relocation never touches stay clean
+// and shared with the page cache, and the parsed copy of the section is
+// released. Everything else is copied from the parsed section data.
+void place_segment(LoadedModule& mod, const ProgramHeader& phdr, int image_fd)
+{
+    auto it = mod.obj.sections.find(phdr.name);
+    if (it == mod.obj.sections.end()) {
+        throw std::runtime_error("Section data not found for segment: " + phdr.name);
+    }
 
-    // Determine load base and map memory
-    if (obj.type == ".exe") {
-        mod.load_base = 0; // Exe has absolute addresses usually
-    } else {
-        // For shared objects, we need to find a space.
-        // Calculate total size required
-        uint64_t min_vaddr = UINT64_MAX;
-        uint64_t max_end = 0;
-        bool has_segments = false;
-
-        for (const auto& phdr : obj.phdrs) {
-            if (phdr.size > 0) {
-                if (phdr.vaddr < min_vaddr)
-                    min_vaddr = phdr.vaddr;
-                uint64_t end = phdr.vaddr + phdr.size;
-                if (end > max_end)
-                    max_end = end;
-                has_segments = true;
-            }
+    uint64_t target = mod.load_base + phdr.vaddr;
+    mod.section_addrs[phdr.name] = target;
+
+    // THP only backs anonymous memory, so huge text is always copied in.
+    // The hint must precede the first touch and is advisory, so failure is not fatal
+    if (wants_huge_pages(phdr, target)) {
+        madvise(reinterpret_cast<void*>(target), phdr.size, MADV_HUGEPAGE);
+    } else if (image_fd >= 0 && phdr.filesz > 0) {
+        uint64_t start = page_down(target);
+        uint64_t end = page_up(target + phdr.filesz);
+        uint64_t file_offset = mod.obj.image_base + phdr.offset - (target - start);
+        count_phase(Phase::Mmap);
+        void* map_res = mmap((void*)start, end - start, PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_FIXED, image_fd, static_cast<off_t>(file_offset));
+        if (map_res == MAP_FAILED) {
+            throw std::runtime_error("Failed to map segment " + phdr.name + ": " + strerror(errno));
         }
+        // The mapping is the only copy we need from now on
+        std::vector<uint8_t>().swap(it->second.data);
+        return;
+    }
 
-        if (has_segments) {
-            uint64_t total_size = max_end;
+    // Copy section data. NOBITS segments (.bss) carry no bytes and rely on
+    // the anonymous mapping being zero
+    if (!it->second.data.empty()) {
+        memcpy((void*)target, it->second.data.data(), std::min<uint64_t>(it->second.data.size(), phdr.size));
+    }
+}
+
+// Map a module as a single contiguous region and fill in its segments.
+// Executables are placed at their absolute addresses, shared objects
+// wherever the kernel finds room for the whole span.
+void map_module(LoadedModule& mod)
+{
+    ModuleSpan span = module_span(mod.obj);
+    if (span.end == 0) {
+        return;
+    }
 
-            void* addr;
+    {
+        PhaseTimer timer(Phase::Mmap);
+        count_phase(Phase::Mmap);
+        if (mod.obj.type == ".exe") {
+            void* map_res = mmap((void*)span.start, span.end - span.start, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_FIXED | MAP_ANONYMOUS, -1, 0);
+            if (map_res == MAP_FAILED) {
+                throw std::runtime_error("Failed to map " + mod.name + ": " + strerror(errno));
+            }
+            mod.load_base = 0;
+        } else {
+            uint64_t base;
             if (need_low_address) {
                 // Use MAP_32BIT for PC32 text relocations (can only reach ±2GB)
-                std::cerr << "Warning: Loading " << filename << " into low 32-bit address space due to PC32 relocations." << std::endl;
-                addr = mmap(NULL, total_size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_32BIT, -1, 0);
-                if (addr == MAP_FAILED) {
+                std::cerr << "Warning: Loading " + mod.name + " into low 32-bit address space due to PC32 relocations.\n";
+                base = reserve_module(mod.obj, span, MAP_32BIT);
+                if (base == 0) {
                     // Fallback without MAP_32BIT
-                    addr = mmap(NULL, total_size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                    base = reserve_module(mod.obj, span, 0);
                 }
             } else {
                 // PIC code (GOT/PLT with R_X86_64_64) can be loaded anywhere
-                addr = mmap(NULL, total_size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                base = reserve_module(mod.obj, span, 0);
             }
 
-            if (addr == MAP_FAILED) {
+            if (base == 0) {
                 throw std::runtime_error("Failed to reserve memory for shared library");
             }
-            mod.load_base = (uint64_t)addr;
-        } else {
-            mod.load_base = 0;
+            mod.load_base = base;
         }
     }
 
-    // Map segments
-    for (const auto& phdr : obj.phdrs) {
+    PhaseTimer timer(Phase::Mmap);
+    int image_fd = open_image(mod);
+    for (const auto& phdr : mod.obj.phdrs) {
         if (phdr.size == 0)
             continue;
+        place_segment(mod, phdr, image_fd);
+    }
+    if (image_fd >= 0)
+        close(image_fd);
+}
 
-        void* target_addr = (void*)(mod.load_base + phdr.vaddr);
-        void* map_res = mmap(target_addr, phdr.size,
-            PROT_READ | PROT_WRITE, // Always RW initially for copying and relocation
-            MAP_PRIVATE | MAP_FIXED | MAP_ANONYMOUS, -1, 0);
+// Apply final permissions to a module with as few mprotect calls as possible.
+// Each page gets the union of the permissions of the segments overlapping it
+// (pages between segments stay inaccessible), then runs of equal permissions
+// are protected in one call.
+void protect_module(const LoadedModule& mod)
+{
+    ModuleSpan span = module_span(mod.obj);
+    if (span.end == 0) {
+        return;
+    }
 
-        if (map_res == MAP_FAILED) {
-            throw std::runtime_error("Failed to map segment " + phdr.name);
-        }
-
-        // Copy section data
-        auto it = obj.sections.find(phdr.name);
-        if (it != obj.sections.end()) {
-            // Skip BSS copying
-            if (phdr.name != ".bss" && !starts_with(phdr.name, ".bss.")) {
-                if (it->second.data.size() > phdr.size) {
-                    // Should not happen if FLE is valid, but safety check
-                    memcpy(target_addr, it->second.data.data(), phdr.size);
-                } else {
-                    memcpy(target_addr, it->second.data.data(), it->second.data.size());
-                }
-            }
-        } else {
-            throw std::runtime_error("Section data not found for segment: " + phdr.name);
+    std::vector<int> page_prot((span.end - span.start) / PAGE_SIZE, PROT_NONE);
+    for (const auto& phdr : mod.obj.phdrs) {
+        if (phdr.size == 0)
+            continue;
+        for (uint64_t page = page_down(phdr.vaddr); page < phdr.vaddr + phdr.size; page += PAGE_SIZE) {
+            page_prot[(page - span.start) / PAGE_SIZE] |= phdr_prot(phdr.flags);
         }
+    }
 
-        // Record section address
-        mod.section_addrs[phdr.name] = (uint64_t)target_addr;
+    PhaseTimer timer(Phase::Mprotect);
+    size_t run = 0;
+    for (size_t i = 1; i <= page_prot.size(); i++) {
+        if (i < page_prot.size() && page_prot[i] == page_prot[run])
+            continue;
+        count_phase(Phase::Mprotect);
+        mprotect((void*)(mod.load_base + span.start + run * PAGE_SIZE), (i - run) * PAGE_SIZE, page_prot[run]);
+        run = i;
     }
+}
 
-    // Add to specific list location (Global symbol resolution order)
-    loaded_modules.push_back(mod);
+// Number of VMAs in this process, reported by FLE_DEBUG=statistics
+size_t count_vmas()
+{
+    std::ifstream maps("/proc/self/maps");
+    size_t count = 0;
+    std::string line;
+    while (std::getline(maps, line)) {
+        count++;
+    }
+    return count;
+}
 
-    // Recursively load dependencies
-    for (const auto& dep : obj.needed) {
-        load_module_recursive(dep);
+// Print the FLE_DEBUG=statistics report for the modules loaded so far
+void report_stats()
+{
+    double total_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - stats.start).count();
+    std::ostringstream out;
+
+    if (stats.json) {
+        json report;
+        report["pid"] = getpid();
+        report["total_ms"] = total_ms;
+        report["vmas_before"] = stats.vmas_before;
+        report["vmas_after"] = stats.vmas_after;
+        json phases = json::array();
+        for (size_t i = 0; i < static_cast<size_t>(Phase::Count); i++) {
+            phases.push_back({ { "name", PHASE_NAMES[i] }, { "ms", stats.phase_ms[i] }, { "count", stats.phase_count[i] } });
+        }
+        report["phases"] = phases;
+        json modules = json::array();
+        for (const auto& mod : loaded_modules) {
+            modules.push_back({
+                { "name", mod.name },
+                { "load_base", mod.load_base },
+                { "dyn_relocs", mod.stats.dyn_relocs },
+                { "dyn_reloc_ms", mod.stats.dyn_reloc_ms },
+                { "section_relocs", mod.stats.section_relocs },
+                { "section_reloc_ms", mod.stats.section_reloc_ms },
+                { "lookup_hits", mod.stats.lookup_hits },
+                { "lookup_misses", mod.stats.lookup_misses },
+            });
+        }
+        report["modules"] = modules;
+        out << report.dump(4) << "\n";
+    } else {
+        std::string prefix = "    " + std::to_string(getpid()) + ":\t";
+        out << std::fixed << std::setprecision(3);
+        out << prefix << "\n";
+        out << prefix << "FLE loader statistics:\n";
+        out << prefix << "  total startup time: " << total_ms << " ms\n";
+        out << prefix << "  VMAs before/after: " << stats.vmas_before << " -> " << stats.vmas_after << "\n";
+        for (size_t i = 0; i < static_cast<size_t>(Phase::Count); i++) {
+            out << prefix << "  " << std::left << std::setw(22) << PHASE_NAMES[i] << std::right
+                << std::setw(10) << stats.phase_ms[i] << " ms" << std::setw(10) << stats.phase_count[i] << "\n";
+        }
+        out << prefix << "\n";
+        out << prefix << "  " << std::left << std::setw(22) << "module" << std::right
+            << std::setw(10) << "dynrel" << std::setw(10) << "dynrel ms"
+            << std::setw(10) << "secrel" << std::setw(10) << "secrel ms"
+            << std::setw(10) << "hits" << std::setw(10) << "misses" << "\n";
+        for (const auto& mod : loaded_modules) {
+            out << prefix << "  " << std::left << std::setw(22) << mod.name << std::right
+                << std::setw(10) << mod.stats.dyn_relocs << std::setw(10) << mod.stats.dyn_reloc_ms
+                << std::setw(10) << mod.stats.section_relocs << std::setw(10) << mod.stats.section_reloc_ms
+                << std::setw(10) << mod.stats.lookup_hits << std::setw(10) << mod.stats.lookup_misses << "\n";
+        }
+    }
+
+    if (!stats.output.empty()) {
+        std::ofstream file(stats.output);
+        file << out.str();
+    } else {
+        std::cerr << out.str() << std::flush;
     }
 }
 
-} // namespace
+// ================= Snapshot cache (exec --snapshot-cache DIR) =================
+//
+// After relocation the loader can dump the fully relocated images of every
+// module into DIR/<exe hash>-<dependency hash>.snap, where the dependency
+// hash combines the content hashes of every loaded library. Keying on both
+// lets several dependency sets of one executable (different
+// FLE_LIBRARY_PATH, rebuilt libraries) keep their own snapshots instead of
+// evicting each other. A later run with unchanged inputs maps those images
+// straight from the cache file with MAP_PRIVATE and skips dependency loading
+// and relocation entirely. Layout of a snapshot:
+//   SnapshotHeader
+//   dep_count x { uint64 hash, uint64 load_base, uint32 name_len, uint32 path_len, name, path }
+//   region_count x SnapshotRegion
+//   page-aligned region images
+
+constexpr char SNAPSHOT_MAGIC[8] = { 'F', 'L', 'E', 'S', 'N', 'A', 'P', '3' };
+
+struct SnapshotHeader {
+    char magic[8];
+    uint64_t exe_hash;
+    uint64_t entry;
+    uint32_t dep_count;
+    uint32_t region_count;
+};
+
+struct SnapshotRegion {
+    uint64_t addr;
+    uint64_t size;
+    uint64_t file_offset; // 0 means zero-filled anonymous memory
+    uint32_t prot;
+    uint32_t reserved;
+};
 
-void FLE_exec(const FLEObject& obj)
+// FNV-1a over the file content, used to key and validate snapshots
+uint64_t hash_file(const std::string& path)
 {
-    if (obj.type != ".exe") {
-        throw std::runtime_error("File is not an executable FLE.");
+    std::ifstream in(path, std::ios::binary);
+    if (!in)
+        throw std::runtime_error("Cannot read " + path);
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    char buf[65536];
+    while (in.read(buf, sizeof(buf)) || in.gcount() > 0) {
+        for (std::streamsize i = 0; i < in.gcount(); i++) {
+            hash = (hash ^ static_cast<uint8_t>(buf[i])) * 0x100000001b3ULL;
+        }
     }
+    return hash;
+}
 
-    // Clear globals for fresh execution
-    loaded_modules.clear();
-    loaded_module_names.clear();
-    scanned_names.clear();
-    need_low_address = false;
-
-    // Pre-scan all dependencies to check if any SO has PC32 dyn_relocs
-    // This must be done BEFORE loading so we know whether to use MAP_32BIT
-    for (const auto& dep : obj.needed) {
-        scan_dependencies_recursive(dep);
+// Combine the dependency hashes in load order into the second half of the key
+uint64_t hash_deps(const std::vector<uint64_t>& dep_hashes)
+{
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (uint64_t dep : dep_hashes) {
+        for (int i = 0; i < 8; i++) {
+            hash = (hash ^ ((dep >> (i * 8)) & 0xff)) * 0x100000001b3ULL;
+        }
     }
+    return hash;
+}
+
+std::string snapshot_prefix(uint64_t exe_hash)
+{
+    std::ostringstream name;
+    name << std::hex << std::setw(16) << std::setfill('0') << exe_hash << "-";
+    return name.str();
+}
 
-    // 1. Load Main Executable (Manual setup for the main object provided)
-    // We treat the passed object as the first module but we need its name.
-    // Since we don't have the filename here, we use a placeholder or obj.name if valid.
+std::string snapshot_path(const ExecOptions& options, uint64_t exe_hash, uint64_t deps_hash)
+{
+    std::ostringstream name;
+    name << snapshot_prefix(exe_hash) << std::hex << std::setw(16) << std::setfill('0') << deps_hash << ".snap";
+    return (std::filesystem::path(options.snapshot_dir) / name.str()).string();
+}
 
-    // Actually, recursive loader expects loading from disk.
-    // But we already have the main object in memory.
-    // We should initialize the main module manually.
+void write_snapshot(const FLEObject& obj, const ExecOptions& options)
+{
+    PhaseTimer timer(Phase::Snapshot);
+    if (options.program_path.empty())
+        return;
 
-    LoadedModule main_mod;
-    main_mod.name = obj.name.empty() ? "main" : obj.name;
-    main_mod.obj = obj;
-    main_mod.load_base = 0;
+    // Page-granular regions of every module. Segments whose section carries
+    // no bytes (.bss) are recorded as anonymous zero memory. A page shared
+    // with the previous segment (ld --pack-segments, -z noseparate-code)
+    // stays in the previous region, since the regions are mapped with
+    // MAP_FIXED_NOREPLACE and must not overlap.
+    std::vector<SnapshotRegion> regions;
+    for (const auto& mod : loaded_modules) {
+        for (const auto& phdr : mod.obj.phdrs) {
+            if (phdr.size == 0)
+                continue;
+            uint64_t start = page_down(mod.load_base + phdr.vaddr);
+            uint64_t end = page_up(mod.load_base + phdr.vaddr + phdr.size);
+            auto it = mod.obj.sections.find(phdr.name);
+            bool zero = phdr.filesz == 0 && (it == mod.obj.sections.end() || it->second.data.empty());
+            if (!regions.empty() && start < regions.back().addr + regions.back().size) {
+                SnapshotRegion& prev = regions.back();
+                prev.prot |= static_cast<uint32_t>(phdr_prot(phdr.flags));
+                prev.file_offset |= static_cast<uint64_t>(!zero);
+                start = prev.addr + prev.size;
+                if (start >= end)
+                    continue;
+            }
+            // file_offset is a has-contents marker here, real offsets are assigned below
+            regions.push_back({ start, end - start, static_cast<uint64_t>(!zero), static_cast<uint32_t>(phdr_prot(phdr.flags)), 0 });
+        }
+    }
 
-    // Map Main Executable segments
-    for (const auto& phdr : obj.phdrs) {
-        if (phdr.size == 0)
+    std::vector<char> meta;
+    auto append = [&](const void* data, size_t size) {
+        const char* p = static_cast<const char*>(data);
+        meta.insert(meta.end(), p, p + size);
+    };
+
+    SnapshotHeader header {};
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    header.exe_hash = hash_file(options.program_path);
+    header.entry = obj.entry;
+    header.dep_count = static_cast<uint32_t>(loaded_modules.size() - 1);
+    header.region_count = static_cast<uint32_t>(regions.size());
+    append(&header, sizeof(header));
+    std::vector<uint64_t> dep_hashes;
+    for (size_t i = 1; i < loaded_modules.size(); i++) {
+        const auto& mod = loaded_modules[i];
+        uint64_t hash = hash_file(mod.path);
+        dep_hashes.push_back(hash);
+        // The table pointer stored in __fle_loader_api belongs to this run
+        // of exec, the restore must store its own there
+        uint64_t api_slot = lookup_in_module(mod, "__fle_loader_api");
+        uint32_t name_len = static_cast<uint32_t>(mod.name.size());
+        uint32_t path_len = static_cast<uint32_t>(mod.path.size());
+        append(&hash, sizeof(hash));
+        append(&mod.load_base, sizeof(mod.load_base));
+        append(&api_slot, sizeof(api_slot));
+        append(&name_len, sizeof(name_len));
+        append(&path_len, sizeof(path_len));
+        append(mod.name.data(), name_len);
+        append(mod.path.data(), path_len);
+    }
+
+    uint64_t offset = page_up(meta.size() + regions.size() * sizeof(SnapshotRegion));
+    for (auto& region : regions) {
+        if (region.file_offset == 0)
             continue;
+        region.file_offset = offset;
+        offset += region.size;
+    }
+    append(regions.data(), regions.size() * sizeof(SnapshotRegion));
+
+    std::error_code ec;
+    std::filesystem::create_directories(options.snapshot_dir, ec);
+    std::string path = snapshot_path(options, header.exe_hash, hash_deps(dep_hashes));
+    std::string tmp = path + ".tmp." + std::to_string(getpid());
+    {
+        std::ofstream out(tmp, std::ios::binary);
+        out.write(meta.data(), meta.size());
+        for (const auto& region : regions) {
+            if (region.file_offset == 0)
+                continue;
+            out.seekp(region.file_offset);
+            out.write(reinterpret_cast<const char*>(region.addr), region.size);
+        }
+        if (!out) {
+            std::filesystem::remove(tmp, ec);
+            return;
+        }
+    }
+    // Publish atomically so concurrent runs never see a partial snapshot
+    std::filesystem::rename(tmp, path, ec);
+}
 
-        void* addr = mmap((void*)phdr.vaddr, phdr.size,
-            PROT_READ | PROT_WRITE, // RW for relocations
-            MAP_PRIVATE | MAP_FIXED | MAP_ANONYMOUS, -1, 0);
+// Map one candidate snapshot. Returns false (with nothing mapped) when it
+// does not match the current executable and dependencies. dep_file_hashes
+// caches file hashes across candidates so each library is read only once.
+bool restore_snapshot_file(FLEObject& obj, const ExecOptions& options, const std::string& path,
+    uint64_t exe_hash, uint64_t deps_hash, std::map<std::string, uint64_t>& dep_file_hashes)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in)
+        return false;
+
+    SnapshotHeader header {};
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))
+        || memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0
+        || header.exe_hash != exe_hash || header.entry != obj.entry) {
+        return false;
+    }
 
+    // Every dependency must still resolve to the same, unchanged file
+    std::vector<LoadedModule> deps;
+    std::vector<uint64_t> dep_hashes;
+    for (uint32_t i = 0; i < header.dep_count; i++) {
+        uint64_t hash, load_base, api_slot;
+        uint32_t name_len, path_len;
+        if (!in.read(reinterpret_cast<char*>(&hash), sizeof(hash))
+            || !in.read(reinterpret_cast<char*>(&load_base), sizeof(load_base))
+            || !in.read(reinterpret_cast<char*>(&api_slot), sizeof(api_slot))
+            || !in.read(reinterpret_cast<char*>(&name_len), sizeof(name_len))
+            || !in.read(reinterpret_cast<char*>(&path_len), sizeof(path_len))) {
+            return false;
+        }
+        std::string name(name_len, '\0'), dep_path(path_len, '\0');
+        if (!in.read(name.data(), name_len) || !in.read(dep_path.data(), path_len))
+            return false;
+        try {
+            if (find_fle_path(name) != dep_path)
+                return false;
+            auto cached = dep_file_hashes.find(dep_path);
+            if (cached == dep_file_hashes.end())
+                cached = dep_file_hashes.emplace(dep_path, hash_file(dep_path)).first;
+            if (cached->second != hash)
+                return false;
+        } catch (...) {
+            return false;
+        }
+        dep_hashes.push_back(hash);
+        LoadedModule mod;
+        mod.name = name;
+        mod.path = dep_path;
+        mod.load_base = load_base;
+        mod.needs_parse = true;
+        mod.loader_api_slot = api_slot;
+        deps.push_back(std::move(mod));
+    }
+    if (hash_deps(dep_hashes) != deps_hash)
+        return false;
+
+    std::vector<SnapshotRegion> regions(header.region_count);
+    if (!in.read(reinterpret_cast<char*>(regions.data()), regions.size() * sizeof(SnapshotRegion)))
+        return false;
+    in.close();
+
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return false;
+
+    std::vector<SnapshotRegion> mapped;
+    bool ok = true;
+    for (const auto& region : regions) {
+        void* want = reinterpret_cast<void*>(region.addr);
+        void* addr = region.file_offset == 0
+            ? mmap(want, region.size, static_cast<int>(region.prot), MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0)
+            : mmap(want, region.size, static_cast<int>(region.prot), MAP_PRIVATE | MAP_FIXED_NOREPLACE, fd, static_cast<off_t>(region.file_offset));
+        count_phase(Phase::Mmap);
         if (addr == MAP_FAILED) {
-            throw std::runtime_error(std::string("mmap failed: ") + strerror(errno));
+            ok = false;
+            break;
         }
-
-        auto it = obj.sections.find(phdr.name);
-        if (it == obj.sections.end()) {
-            throw std::runtime_error("Section not found: " + phdr.name);
+        if (addr != want) {
+            // Kernels without MAP_FIXED_NOREPLACE treat the address as a hint
+            munmap(addr, region.size);
+            ok = false;
+            break;
         }
+        mapped.push_back(region);
+    }
+    close(fd);
 
-        if (phdr.name != ".bss" && !starts_with(phdr.name, ".bss.")) {
-            memcpy(addr, it->second.data.data(), phdr.size);
+    if (!ok) {
+        for (const auto& region : mapped) {
+            munmap(reinterpret_cast<void*>(region.addr), region.size);
         }
+        return false;
+    }
+    count_phase(Phase::Snapshot);
 
-        main_mod.section_addrs[phdr.name] = phdr.vaddr;
+    // Module table for fle_dlopen: the executable is already parsed, the
+    // dependencies are only read if the program ever loads something
+    LoadedModule main_mod;
+    main_mod.name = obj.name.empty() ? "main" : obj.name;
+    main_mod.path = options.program_path;
+    main_mod.obj = std::move(obj);
+    for (const auto& phdr : main_mod.obj.phdrs) {
+        if (phdr.size > 0)
+            main_mod.section_addrs[phdr.name] = phdr.vaddr;
+    }
+    loaded_modules.clear();
+    loaded_modules.push_back(std::move(main_mod));
+    for (auto& dep : deps) {
+        loaded_modules.push_back(std::move(dep));
     }
+    return true;
+}
 
-    loaded_modules.push_back(main_mod);
-    loaded_module_names.insert(main_mod.name);
+// Try to start from a snapshot. Every DIR/<exe hash>-*.snap is a candidate,
+// the first one whose dependencies are unchanged wins. Returns false when
+// none is usable, so the caller falls back to the normal loader.
+bool restore_snapshot(FLEObject& obj, const ExecOptions& options)
+{
+    PhaseTimer timer(Phase::Snapshot);
+    if (options.program_path.empty())
+        return false;
+
+    uint64_t exe_hash = hash_file(options.program_path);
+    std::string prefix = snapshot_prefix(exe_hash);
+    std::vector<std::pair<std::string, uint64_t>> candidates;
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(options.snapshot_dir, ec)) {
+        std::string file = entry.path().filename().string();
+        if (file.size() != prefix.size() + 16 + 5 || file.compare(0, prefix.size(), prefix) != 0
+            || file.compare(file.size() - 5, 5, ".snap") != 0) {
+            continue;
+        }
+        try {
+            candidates.emplace_back(entry.path().string(), std::stoull(file.substr(prefix.size(), 16), nullptr, 16));
+        } catch (...) {
+            continue;
+        }
+    }
+    // Directory order is unspecified, keep the choice deterministic
+    std::sort(candidates.begin(), candidates.end());
 
-    // Load dependencies of main
-    for (const auto& dep : obj.needed) {
-        load_module_recursive(dep);
+    std::map<std::string, uint64_t> dep_file_hashes;
+    for (const auto& [path, deps_hash] : candidates) {
+        if (restore_snapshot_file(obj, options, path, exe_hash, deps_hash, dep_file_hashes))
+            return true;
     }
+    return false;
+}
 
-    // 2. Perform Relocations for ALL modules
-    for (auto& mod : loaded_modules) {
+// ================= Lazy loading (ld -z lazyload) =================
+//
+// Libraries the executable marks lazy are not loaded at startup. Instead the
+// GOT slot of every function they provide points at a small stub in an
+// executable arena:
+//   push $index; jmp *fle_lazy_trampoline
+// The trampoline saves the argument registers and calls fle_lazy_bind, which
+// loads the library, patches the GOT slots of the symbol and returns its
+// address; the trampoline then restores the registers and jumps there, so the
+// first call proceeds as if it had been bound all along.
+
+struct LazySymbol {
+    std::string symbol;
+    std::string library;
+    std::vector<uint64_t> slots; // GOT slots currently pointing at the stub
+};
 
-        // A. Dynamic Relocations (Bonus 1 - Text Relocations for SO, Bonus 2 - GOT for EXE)
-        // For .so: dyn_relocs.offset is relative to merged section data (typically .text)
-        // For .exe: dyn_relocs.offset is VMA (already resolved during linking)
-        for (const auto& reloc : mod.obj.dyn_relocs) {
-            uint64_t reloc_addr;
+constexpr uint64_t LAZY_STUB_SIZE = 32;
 
-            if (mod.obj.type == ".exe") {
-                // For executables, offset is the VMA
-                reloc_addr = reloc.offset;
-            } else {
-                // For shared objects, offset is VMA relative to Load Base
-                reloc_addr = mod.load_base + reloc.offset;
-            }
+std::vector<LazySymbol> lazy_symbols; // Indexed by stub number
+std::unordered_map<std::string, size_t> lazy_index; // Symbol -> stub number
+uint64_t lazy_arena = 0;
 
-            uint64_t sym_addr = resolve_symbol(reloc.symbol);
+// Stub address for a GOT slot of the executable that refers to a function in
+// a library still waiting to be loaded, 0 if the slot is bound normally
+uint64_t lazy_stub_for(const LoadedModule& mod, const Relocation& reloc, uint64_t slot)
+{
+    if (lazy_arena == 0 || &mod != &loaded_modules.front() || reloc.type != RelocationType::R_X86_64_64)
+        return 0;
+    auto it = lazy_index.find(reloc.symbol);
+    if (it == lazy_index.end())
+        return 0;
+    lazy_symbols[it->second].slots.push_back(slot);
+    return lazy_arena + it->second * LAZY_STUB_SIZE + reloc.addend;
+}
+
+// ================= IFUNC resolution =================
+//
+// A slot that refers to an IFUNC gets the address returned by its resolver.
+// Resolvers are program code (typically a cpuid check), so they can only run
+// once every module has its final permissions; relocate_module queues these
+// slots and apply_ifunc_fixups fills them afterwards. Calls then go through
+// the PLT straight to the chosen implementation.
+
+struct IfuncFixup {
+    uint64_t addr; // Address of the slot
+    uint64_t resolver;
+    RelocationType type;
+    int64_t addend;
+    int prot; // Final permissions of the slot's page
+};
+
+std::vector<IfuncFixup> ifunc_fixups;
+std::mutex ifunc_mutex;
+
+uint64_t call_resolver(uint64_t resolver)
+{
+    return reinterpret_cast<uint64_t (*)()>(resolver)();
+}
+
+// Permissions protect_module gives the page holding addr
+int page_prot_at(const LoadedModule& mod, uint64_t addr)
+{
+    int prot = PROT_NONE;
+    uint64_t page = page_down(addr);
+    for (const auto& phdr : mod.obj.phdrs) {
+        uint64_t start = mod.load_base + phdr.vaddr;
+        if (phdr.size > 0 && page_down(start) <= page && page < start + phdr.size)
+            prot |= phdr_prot(phdr.flags);
+    }
+    return prot;
+}
+
+void queue_ifunc(const LoadedModule& mod, uint64_t addr, uint64_t resolver, RelocationType type, int64_t addend)
+{
+    std::lock_guard<std::mutex> lock(ifunc_mutex);
+    ifunc_fixups.push_back({ addr, resolver, type, addend, page_prot_at(mod, addr) });
+}
+
+// Run each queued resolver once and store its result. Slots in read-only
+// pages (text relocations in shared objects) are unprotected for the write.
+void apply_ifunc_fixups()
+{
+    std::vector<IfuncFixup> fixups;
+    {
+        std::lock_guard<std::mutex> lock(ifunc_mutex);
+        fixups.swap(ifunc_fixups);
+    }
+    std::unordered_map<uint64_t, uint64_t> chosen;
+    for (const auto& fixup : fixups) {
+        auto it = chosen.find(fixup.resolver);
+        if (it == chosen.end()) {
+            it = chosen.emplace(fixup.resolver, call_resolver(fixup.resolver)).first;
+        }
+        uint64_t value = it->second + fixup.addend;
+
+        void* page = reinterpret_cast<void*>(page_down(fixup.addr));
+        size_t len = page_up(fixup.addr + sizeof(uint64_t)) - page_down(fixup.addr);
+        bool writable = fixup.prot & PROT_WRITE;
+        if (!writable)
+            mprotect(page, len, fixup.prot | PROT_WRITE);
+        switch (fixup.type) {
+        case RelocationType::R_X86_64_64:
+        case RelocationType::R_X86_64_IRELATIVE:
+            *(uint64_t*)fixup.addr = value;
+            break;
+        case RelocationType::R_X86_64_32:
+        case RelocationType::R_X86_64_32S:
+            *(uint32_t*)fixup.addr = (uint32_t)value;
+            break;
+        case RelocationType::R_X86_64_PC32:
+        case RelocationType::R_X86_64_GOTPCREL:
+        case RelocationType::R_X86_64_GOTPCRELX:
+            *(uint32_t*)fixup.addr = (uint32_t)(value - fixup.addr);
+            break;
+        case RelocationType::R_X86_64_TPOFF32:
+        case RelocationType::R_X86_64_GOTTPOFF:
+            break; // Never queued: static TLS offsets are final after ld
+        }
+        if (!writable)
+            mprotect(page, len, fixup.prot);
+    }
+}
+
+// Apply the dynamic and section relocations of one module. Every symbol
+// provider must already be mapped; only the module's own pages are written.
+void relocate_module(LoadedModule& mod)
+{
+    // A. Dynamic Relocations (Bonus 1 - Text Relocations for SO, Bonus 2 - GOT for EXE)
+    // For .so: dyn_relocs.offset is relative to merged section data (typically .text)
+    // For .exe: dyn_relocs.offset is VMA (already resolved during linking)
+    {
+        PhaseTimer dyn_timer(Phase::DynRelocs, &mod.stats.dyn_reloc_ms);
+        mod.stats.dyn_relocs = mod.obj.dyn_relocs.size();
+        count_phase(Phase::DynRelocs, mod.obj.dyn_relocs.size());
+        for (const auto& reloc : mod.obj.dyn_relocs) {
+            uint64_t reloc_addr;
+
+            if (mod.obj.type == ".exe") {
+                // For executables, offset is the VMA
+                reloc_addr = reloc.offset;
+            } else {
+                // For shared objects, offset is VMA relative to Load Base
+                reloc_addr = mod.load_base + reloc.offset;
+            }
+
+            // The executable's own IFUNCs: the addend is the resolver
+            if (reloc.type == RelocationType::R_X86_64_IRELATIVE) {
+                queue_ifunc(mod, reloc_addr, mod.load_base + reloc.addend, reloc.type, 0);
+                continue;
+            }
+
+            // GOT slots of functions in libraries not loaded yet go to a binding stub
+            uint64_t sym_addr = lazy_stub_for(mod, reloc, reloc_addr);
+            if (sym_addr != 0) {
+                *(uint64_t*)reloc_addr = sym_addr;
+                continue;
+            }
+            bool ifunc = false;
+            sym_addr = resolve_symbol(reloc.symbol, &ifunc);
+            if (ifunc) {
+                queue_ifunc(mod, reloc_addr, sym_addr, reloc.type, reloc.addend);
+                continue;
+            }
 
             switch (reloc.type) {
             case RelocationType::R_X86_64_64:
@@ -401,86 +1206,1294 @@ void FLE_exec(const FLEObject& obj)
                 *(uint32_t*)reloc_addr = (uint32_t)(sym_addr + reloc.addend - reloc_addr);
                 break;
             case RelocationType::R_X86_64_GOTPCREL:
+            case RelocationType::R_X86_64_GOTPCRELX:
                 *(uint32_t*)reloc_addr = (uint32_t)(sym_addr + reloc.addend - reloc_addr);
                 break;
+            case RelocationType::R_X86_64_IRELATIVE:
+                break; // Queued above
+            case RelocationType::R_X86_64_TPOFF32:
+            case RelocationType::R_X86_64_GOTTPOFF:
+                throw std::runtime_error("TLS relocation against " + reloc.symbol + " left for the loader in " + mod.name);
             }
         }
+    }
 
-        // B. Section Relocations (Bonus 1 - Text Relocations)
-        // Iterate over sections to find relocations
-        for (const auto& kv : mod.obj.sections) {
-            const auto& name = kv.first;
-            const auto& section = kv.second;
+    // B. Section Relocations (Bonus 1 - Text Relocations)
+    // Iterate over sections to find relocations
+    for (const auto& kv : mod.obj.sections) {
+        const auto& name = kv.first;
+        const auto& section = kv.second;
 
-            // Check if this section is loaded.
-            auto addr_it = mod.section_addrs.find(name);
-            if (addr_it == mod.section_addrs.end())
-                continue;
+        // Check if this section is loaded.
+        auto addr_it = mod.section_addrs.find(name);
+        if (addr_it == mod.section_addrs.end())
+            continue;
 
-            // In FLE, section relocs have offset relative to the section start
-            // phdr.vaddr corresponds to the section start VMA relative to Load Base (for SO) or Absolute (for EXE)
-            // Wait, for .so, phdr.vaddr is offset from base.
-            // But we stored the Absolute Runtime Address in section_addrs.
-            // But apply_reloc adds load_base + section_base ...
-
-            // Let's adjust logic.
-            // For Main (.exe), load_base = 0. section_addr is absolute.
-            // For .so, load_base = allocated. section_addr is absolute = load_base + vaddr.
-
-            // Reloc offset is relative to section start.
-            // address = section_absolute_start + reloc.offset.
-            // We can pass `section_absolute_start - load_base` as 2nd arg?
-            // Or just calculate address and adapt lambda.
-
-            uint64_t section_runtime_addr = addr_it->second;
-
-            for (const auto& reloc : section.relocs) {
-                uint64_t sym_addr = resolve_symbol(reloc.symbol);
-                uint64_t reloc_addr = section_runtime_addr + reloc.offset;
-
-                switch (reloc.type) {
-                case RelocationType::R_X86_64_64:
-                    *(uint64_t*)reloc_addr = sym_addr + reloc.addend;
-                    break;
-                case RelocationType::R_X86_64_32:
-                    *(uint32_t*)reloc_addr = (uint32_t)(sym_addr + reloc.addend);
-                    break;
-                case RelocationType::R_X86_64_32S:
-                    *(int32_t*)reloc_addr = (int32_t)(sym_addr + reloc.addend);
-                    break;
-                case RelocationType::R_X86_64_PC32:
-                    *(uint32_t*)reloc_addr = (uint32_t)(sym_addr + reloc.addend - reloc_addr);
-                    break;
-                case RelocationType::R_X86_64_GOTPCREL:
-                    *(uint32_t*)reloc_addr = (uint32_t)(sym_addr + reloc.addend - reloc_addr);
-                    break;
-                }
+        // In FLE, section relocs have offset relative to the section start
+        // phdr.vaddr corresponds to the section start VMA relative to Load Base (for SO) or Absolute (for EXE)
+        // Wait, for .so, phdr.vaddr is offset from base.
+        // But we stored the Absolute Runtime Address in section_addrs.
+        // But apply_reloc adds load_base + section_base ...
+
+        // Let's adjust logic.
+        // For Main (.exe), load_base = 0. section_addr is absolute.
+        // For .so, load_base = allocated. section_addr is absolute = load_base + vaddr.
+
+        // Reloc offset is relative to section start.
+        // address = section_absolute_start + reloc.offset.
+        // We can pass `section_absolute_start - load_base` as 2nd arg?
+        // Or just calculate address and adapt lambda.
+
+        uint64_t section_runtime_addr = addr_it->second;
+
+        PhaseTimer section_timer(Phase::SectionRelocs, &mod.stats.section_reloc_ms);
+        mod.stats.section_relocs += section.relocs.size();
+        count_phase(Phase::SectionRelocs, section.relocs.size());
+        for (const auto& reloc : section.relocs) {
+            uint64_t sym_addr = resolve_symbol(reloc.symbol);
+            uint64_t reloc_addr = section_runtime_addr + reloc.offset;
+
+            switch (reloc.type) {
+            case RelocationType::R_X86_64_64:
+                *(uint64_t*)reloc_addr = sym_addr + reloc.addend;
+                break;
+            case RelocationType::R_X86_64_32:
+                *(uint32_t*)reloc_addr = (uint32_t)(sym_addr + reloc.addend);
+                break;
+            case RelocationType::R_X86_64_32S:
+                *(int32_t*)reloc_addr = (int32_t)(sym_addr + reloc.addend);
+                break;
+            case RelocationType::R_X86_64_PC32:
+                *(uint32_t*)reloc_addr = (uint32_t)(sym_addr + reloc.addend - reloc_addr);
+                break;
+            case RelocationType::R_X86_64_GOTPCREL:
+            case RelocationType::R_X86_64_GOTPCRELX:
+                *(uint32_t*)reloc_addr = (uint32_t)(sym_addr + reloc.addend - reloc_addr);
+                break;
+            case RelocationType::R_X86_64_IRELATIVE:
+                throw std::runtime_error("IRELATIVE relocation outside dyn_relocs in " + mod.name);
+            case RelocationType::R_X86_64_TPOFF32:
+            case RelocationType::R_X86_64_GOTTPOFF:
+                throw std::runtime_error("TLS relocation against " + reloc.symbol + " left for the loader in " + mod.name);
             }
         }
     }
+}
 
-    // 3. Set Permissions (after all relocations are done)
-    for (const auto& mod : loaded_modules) {
+// ================= Static TLS =================
+//
+// A program with thread-local variables gets one static TLS block for its
+// main thread, with the layout ld computed offsets for: the block ends at the
+// thread pointer and a TCB page follows it. The loader is glibc code that
+// needs glibc's %fs, so the program's thread pointer is installed only when
+// control passes to the entry point, and loader code called back from the
+// program switches to the host's thread pointer for its duration.
+
+uint64_t program_tp = 0; // 0 if the program has no TLS
+uint64_t host_tp = 0;
+
+// Both glibc and our TCB keep the thread pointer itself at %fs:0
+uint64_t current_tp()
+{
+    uint64_t tp;
+    asm volatile("mov %%fs:0, %0" : "=r"(tp));
+    return tp;
+}
+
+// A raw syscall: the glibc wrapper may touch errno, which lives behind %fs
+void set_tp(uint64_t tp)
+{
+    long ret;
+    asm volatile("syscall"
+                 : "=a"(ret)
+                 : "0"(SYS_arch_prctl), "D"(ARCH_SET_FS), "S"(tp)
+                 : "rcx", "r11", "memory");
+}
+
+void setup_static_tls(const FLEObject& exe)
+{
+    program_tp = 0;
+    if (exe.tls.memsz == 0) {
+        return;
+    }
+    uint64_t block = (exe.tls.memsz + exe.tls.align - 1) / exe.tls.align * exe.tls.align;
+    uint64_t size = page_up(block) + PAGE_SIZE;
+    void* area = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (area == MAP_FAILED) {
+        throw std::runtime_error(std::string("Failed to map the TLS block: ") + strerror(errno));
+    }
+    uint64_t tp = reinterpret_cast<uint64_t>(area) + page_up(block);
+    memcpy(reinterpret_cast<void*>(tp - block), reinterpret_cast<const void*>(exe.tls.vaddr), exe.tls.filesz);
+
+    // TCB: the self pointer at %fs:0 and the stack protector canary at %fs:0x28,
+    // copied from the host so functions switching %fs see the same canary
+    uint64_t* tcb = reinterpret_cast<uint64_t*>(tp);
+    tcb[0] = tp;
+    asm volatile("mov %%fs:0x28, %0" : "=r"(tcb[5]));
+    program_tp = tp;
+}
+
+// Switch to the program's thread pointer just before entering it
+void enter_program_tls()
+{
+    if (program_tp != 0) {
+        host_tp = current_tp();
+        set_tp(program_tp);
+    }
+}
+
+// Scope in which loader code called from the program runs on the host's
+// thread pointer
+class HostTlsScope {
+public:
+    HostTlsScope()
+        : swapped_(program_tp != 0 && current_tp() == program_tp)
+    {
+        if (swapped_)
+            set_tp(host_tp);
+    }
+    ~HostTlsScope()
+    {
+        if (swapped_)
+            set_tp(program_tp);
+    }
+    HostTlsScope(const HostTlsScope&) = delete;
+    HostTlsScope& operator=(const HostTlsScope&) = delete;
+
+private:
+    bool swapped_;
+};
+
+// ================= Runtime loading API (fle_dlopen & co.) =================
+//
+// FLE programs reach the loader through a table of host function pointers.
+// minilibc defines `struct fle_loader_api* __fle_loader_api`; once a module
+// is relocated the loader stores the address of its table there. The entries
+// are plain C calls running on the program's stack, so they must never let a
+// C++ exception escape; errors are reported through fle_dlerror() instead.
+//
+// Modules opened at runtime are appended to loaded_modules (after everything
+// loaded at startup, so they never shadow startup symbols). A handle is the
+// module's index + 1; unloaded modules keep their slot so handles stay valid.
+
+// Must match struct fle_loader_api in tests/common/minilibc.c
+struct FleLoaderApi {
+    uint64_t version;
+    void* (*dlopen)(const char* name);
+    void* (*dlsym)(void* handle, const char* name);
+    int (*dlclose)(void* handle);
+    const char* (*dlerror)();
+};
+
+constexpr uint64_t FLE_LOADER_API_VERSION = 1;
+
+std::string dl_error;
+bool dl_error_pending = false;
+
+void set_dl_error(const std::string& message)
+{
+    dl_error = message;
+    dl_error_pending = true;
+}
+
+// Parse the symbol tables of modules restored from a snapshot, whose images
+// are already mapped at load_base
+void ensure_module_table()
+{
+    std::vector<size_t> pending;
+    for (size_t i = 0; i < loaded_modules.size(); i++) {
+        if (loaded_modules[i].needs_parse)
+            pending.push_back(i);
+    }
+    parallel_for(pending.size(), [&](size_t i) {
+        LoadedModule& mod = loaded_modules[pending[i]];
+        mod.obj = parse_fle(mod.path);
         for (const auto& phdr : mod.obj.phdrs) {
-            if (phdr.size == 0)
-                continue;
+            if (phdr.size > 0)
+                mod.section_addrs[phdr.name] = mod.load_base + phdr.vaddr;
+        }
+        mod.needs_parse = false;
+    });
+}
 
-            // Find runtime address
-            uint64_t addr = mod.load_base + phdr.vaddr;
+size_t find_loaded(const std::string& name)
+{
+    for (size_t i = 0; i < loaded_modules.size(); i++) {
+        if (!loaded_modules[i].unloaded && loaded_modules[i].name == name)
+            return i;
+    }
+    return SIZE_MAX;
+}
 
-            mprotect((void*)addr, phdr.size,
-                (phdr.flags & PHF::R ? PROT_READ : 0)
-                    | (phdr.flags & PHF::W ? PROT_WRITE : 0)
-                    | (phdr.flags & PHF::X ? PROT_EXEC : 0));
+// The module at index and everything it (transitively) needs, in search order
+std::vector<size_t> module_closure(size_t index)
+{
+    std::vector<size_t> closure { index };
+    for (size_t i = 0; i < closure.size(); i++) {
+        for (const auto& dep : loaded_modules[closure[i]].obj.needed) {
+            size_t dep_index = find_loaded(dep);
+            if (dep_index != SIZE_MAX && std::find(closure.begin(), closure.end(), dep_index) == closure.end())
+                closure.push_back(dep_index);
         }
     }
+    return closure;
+}
 
-    // 4. Jump to Entry
+void unload_module(LoadedModule& mod)
+{
+    ModuleSpan span = module_span(mod.obj);
+    if (mod.load_base != 0 && span.end != 0) {
+        munmap(reinterpret_cast<void*>(mod.load_base + span.start), span.end - span.start);
+    }
+    mod.obj = FLEObject {};
+    mod.section_addrs.clear();
+    mod.unloaded = true;
+}
+
+// Store the loader API table into the module's __fle_loader_api, if it has one.
+// A module restored from a snapshot is not parsed yet, its slot address comes
+// from the snapshot
+void install_loader_api(LoadedModule& mod)
+{
+    static FleLoaderApi api;
+    api.version = FLE_LOADER_API_VERSION;
+    api.dlopen = fle_dlopen;
+    api.dlsym = fle_dlsym;
+    api.dlclose = fle_dlclose;
+    api.dlerror = fle_dlerror;
+
+    uint64_t slot = mod.needs_parse ? mod.loader_api_slot : lookup_in_module(mod, "__fle_loader_api");
+    if (slot != 0) {
+        *reinterpret_cast<FleLoaderApi**>(slot) = &api;
+    }
+}
+
+// Tells the sampling profiler about a module loaded after startup, see below
+void record_runtime_load(const LoadedModule& mod);
+
+// Load `name` and whatever it needs that is not loaded yet, using the same
+// discover / map / relocate / protect phases as startup. Returns the index
+// of the new root module. Dynamic modules can be unloaded by fle_dlclose.
+size_t load_at_runtime(const std::string& name, bool dynamic)
+{
+    std::unordered_set<std::string> loaded;
+    for (const auto& mod : loaded_modules) {
+        if (!mod.unloaded)
+            loaded.insert(mod.name);
+    }
+    std::vector<LoadedModule> fresh = discover_dependencies({ name }, loaded);
+    if (fresh.front().obj.type != ".so") {
+        throw std::runtime_error(name + " is not a shared library");
+    }
+
+    size_t first = loaded_modules.size();
+    for (auto& mod : fresh) {
+        mod.dynamic = dynamic;
+        loaded_modules.push_back(std::move(mod));
+    }
+    size_t count = loaded_modules.size() - first;
+
+    try {
+        parallel_for(count, [&](size_t i) {
+            map_module(loaded_modules[first + i]);
+        });
+        parallel_for(count, [&](size_t i) {
+            relocate_module(loaded_modules[first + i]);
+        });
+    } catch (...) {
+        for (size_t i = first; i < loaded_modules.size(); i++) {
+            unload_module(loaded_modules[i]);
+        }
+        loaded_modules.resize(first);
+        ifunc_fixups.clear();
+        throw;
+    }
+    for (size_t i = first; i < loaded_modules.size(); i++) {
+        install_loader_api(loaded_modules[i]);
+        protect_module(loaded_modules[i]);
+        record_runtime_load(loaded_modules[i]);
+    }
+    apply_ifunc_fixups();
+    return first;
+}
+
+// Validate a handle from the program, returning the module index
+size_t handle_index(void* handle)
+{
+    uint64_t value = reinterpret_cast<uint64_t>(handle);
+    if (value == 0 || value > loaded_modules.size() || loaded_modules[value - 1].unloaded) {
+        throw std::runtime_error("invalid handle");
+    }
+    return value - 1;
+}
+
+} // namespace
+
+// The API entry points have C linkage so the program can call them directly
+
+extern "C" void* fle_dlopen(const char* name)
+{
+    HostTlsScope host_tls;
+    try {
+        ensure_module_table();
+        size_t index = find_loaded(name);
+        if (index == SIZE_MAX) {
+            index = load_at_runtime(name, true);
+        }
+        for (size_t i : module_closure(index)) {
+            if (loaded_modules[i].dynamic)
+                loaded_modules[i].dl_refs++;
+        }
+        return reinterpret_cast<void*>(index + 1);
+    } catch (const std::exception& e) {
+        set_dl_error(e.what());
+        return nullptr;
+    }
+}
+
+// A null handle searches every loaded module in global order, like RTLD_DEFAULT
+extern "C" void* fle_dlsym(void* handle, const char* name)
+{
+    HostTlsScope host_tls;
+    try {
+        ensure_module_table();
+        bool ifunc = false;
+        if (handle == nullptr) {
+            uint64_t addr = resolve_symbol(name, &ifunc);
+            return reinterpret_cast<void*>(ifunc ? call_resolver(addr) : addr);
+        }
+        for (size_t i : module_closure(handle_index(handle))) {
+            uint64_t addr = lookup_in_module(loaded_modules[i], name, &ifunc);
+            if (addr != 0)
+                return reinterpret_cast<void*>(ifunc ? call_resolver(addr) : addr);
+        }
+        throw std::runtime_error(std::string("Symbol not found: ") + name);
+    } catch (const std::exception& e) {
+        set_dl_error(e.what());
+        return nullptr;
+    }
+}
+
+// Modules loaded at startup are never unmapped; closing them is a no-op
+extern "C" int fle_dlclose(void* handle)
+{
+    HostTlsScope host_tls;
+    try {
+        std::vector<size_t> closure = module_closure(handle_index(handle));
+        for (size_t i : closure) {
+            if (loaded_modules[i].dynamic && loaded_modules[i].dl_refs > 0)
+                loaded_modules[i].dl_refs--;
+        }
+        for (size_t i : closure) {
+            if (loaded_modules[i].dynamic && loaded_modules[i].dl_refs == 0)
+                unload_module(loaded_modules[i]);
+        }
+        return 0;
+    } catch (const std::exception& e) {
+        set_dl_error(e.what());
+        return -1;
+    }
+}
+
+// Last error since the previous call, or null; clears the error like dlerror(3)
+extern "C" const char* fle_dlerror()
+{
+    HostTlsScope host_tls;
+    if (!dl_error_pending)
+        return nullptr;
+    dl_error_pending = false;
+    return dl_error.c_str();
+}
+
+
+// Called by fle_lazy_trampoline on the first call through a lazy stub.
+// There is no caller to report an error to, so failures are fatal, like an
+// unresolvable symbol in the dynamic linker.
+extern "C" uint64_t fle_lazy_bind(uint64_t index)
+{
+    HostTlsScope host_tls;
+    LazySymbol& lazy = lazy_symbols[index];
+    try {
+        size_t lib = find_loaded(lazy.library);
+        if (lib == SIZE_MAX) {
+            lib = load_at_runtime(lazy.library, false);
+        }
+        uint64_t addr = 0;
+        bool ifunc = false;
+        for (size_t i : module_closure(lib)) {
+            addr = lookup_in_module(loaded_modules[i], lazy.symbol, &ifunc);
+            if (addr != 0)
+                break;
+        }
+        if (addr == 0) {
+            throw std::runtime_error("Symbol not found: " + lazy.symbol);
+        }
+        if (ifunc) {
+            addr = call_resolver(addr);
+        }
+        for (uint64_t slot : lazy.slots) {
+            *reinterpret_cast<uint64_t*>(slot) = addr;
+        }
+        return addr;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: lazy binding of " << lazy.symbol << " in " << lazy.library << " failed: " << e.what() << std::endl;
+        _exit(127);
+    }
+}
+
+// Saves the argument registers (%rax carries the vector register count of
+// varargs calls), binds the symbol and tail-jumps to it. On entry the stack
+// holds the stub index above the caller's return address, which leaves %rsp
+// 16-byte aligned after the pushes below.
+asm(R"(
+    .text
+    .globl fle_lazy_trampoline
+    .type fle_lazy_trampoline, @function
+fle_lazy_trampoline:
+    push %rbp
+    mov %rsp, %rbp
+    push %rax
+    push %rdi
+    push %rsi
+    push %rdx
+    push %rcx
+    push %r8
+    push %r9
+    sub $128, %rsp
+    movdqu %xmm0, 0(%rsp)
+    movdqu %xmm1, 16(%rsp)
+    movdqu %xmm2, 32(%rsp)
+    movdqu %xmm3, 48(%rsp)
+    movdqu %xmm4, 64(%rsp)
+    movdqu %xmm5, 80(%rsp)
+    movdqu %xmm6, 96(%rsp)
+    movdqu %xmm7, 112(%rsp)
+    mov 8(%rbp), %rdi
+    call fle_lazy_bind@PLT
+    mov %rax, %r11
+    movdqu 0(%rsp), %xmm0
+    movdqu 16(%rsp), %xmm1
+    movdqu 32(%rsp), %xmm2
+    movdqu 48(%rsp), %xmm3
+    movdqu 64(%rsp), %xmm4
+    movdqu 80(%rsp), %xmm5
+    movdqu 96(%rsp), %xmm6
+    movdqu 112(%rsp), %xmm7
+    add $128, %rsp
+    pop %r9
+    pop %r8
+    pop %rcx
+    pop %rdx
+    pop %rsi
+    pop %rdi
+    pop %rax
+    pop %rbp
+    add $8, %rsp
+    jmp *%r11
+    .size fle_lazy_trampoline, .-fle_lazy_trampoline
+)");
+
+namespace {
+
+// Build the stub arena for the lazy libraries of the executable that were not
+// pulled in at startup anyway (as a dependency of an eagerly loaded module)
+void prepare_lazy_stubs(const FLEObject& exe)
+{
+    lazy_symbols.clear();
+    lazy_index.clear();
+    lazy_arena = 0;
+    for (const auto& [library, symbols] : exe.lazy) {
+        if (find_loaded(library) != SIZE_MAX)
+            continue;
+        for (const auto& symbol : symbols) {
+            if (lazy_index.emplace(symbol, lazy_symbols.size()).second)
+                lazy_symbols.push_back({ symbol, library, {} });
+        }
+    }
+    if (lazy_symbols.empty())
+        return;
+
+    uint64_t size = page_up(lazy_symbols.size() * LAZY_STUB_SIZE);
+    void* arena = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (arena == MAP_FAILED) {
+        throw std::runtime_error("Failed to map lazy binding stubs");
+    }
+    uint64_t trampoline = reinterpret_cast<uint64_t>(&fle_lazy_trampoline);
+    for (size_t i = 0; i < lazy_symbols.size(); i++) {
+        uint8_t* stub = static_cast<uint8_t*>(arena) + i * LAZY_STUB_SIZE;
+        uint32_t index = static_cast<uint32_t>(i);
+        stub[0] = 0x68; // push $index
+        memcpy(stub + 1, &index, sizeof(index));
+        const uint8_t jmp[] = { 0xff, 0x25, 0, 0, 0, 0 }; // jmp *0(%rip)
+        memcpy(stub + 5, jmp, sizeof(jmp));
+        memcpy(stub + 11, &trampoline, sizeof(trampoline));
+    }
+    mprotect(arena, size, PROT_READ | PROT_EXEC);
+    lazy_arena = reinterpret_cast<uint64_t>(arena);
+}
+
+// Map and relocate the executable and all of its dependencies. After this
+// returns every module is mapped with its final permissions and the program
+// is ready to jump to its entry point.
+void load_program(FLEObject obj, const ExecOptions& options)
+{
+    // Clear globals for fresh execution
+    loaded_modules.clear();
+    need_low_address = false;
+    use_huge_pages = options.huge_pages;
+    loader_jobs = options.jobs;
+
+    // 1. Find and parse the whole dependency graph. This also tells us
+    // whether any SO has PC32 dyn_relocs, which must be known BEFORE mapping
+    // so we know whether to use MAP_32BIT
+    // Libraries marked lazy are left for their first call
+    std::vector<std::string> eager;
+    for (const auto& dep : obj.needed) {
+        if (!obj.lazy.count(dep))
+            eager.push_back(dep);
+    }
+    std::vector<LoadedModule> deps = discover_dependencies(eager);
+
+    LoadedModule main_mod;
+    main_mod.name = obj.name.empty() ? "main" : obj.name;
+    main_mod.path = options.program_path;
+    main_mod.obj = std::move(obj);
+
+    loaded_modules.reserve(deps.size() + 1);
+    loaded_modules.push_back(std::move(main_mod));
+    for (auto& dep : deps) {
+        loaded_modules.push_back(std::move(dep));
+    }
+
+    // 2. Map modules. The executable goes first so that its fixed addresses
+    // are taken before shared objects reserve space concurrently
+    map_module(loaded_modules.front());
+    parallel_for(loaded_modules.size() - 1, [](size_t i) {
+        map_module(loaded_modules[i + 1]);
+    });
+
+    // 3. Perform Relocations for ALL modules. Every symbol provider is mapped
+    // by now and each module only writes to its own pages, so modules are
+    // relocated in parallel
+    prepare_lazy_stubs(loaded_modules.front().obj);
+    parallel_for(loaded_modules.size(), [](size_t index) {
+        relocate_module(loaded_modules[index]);
+    });
+    for (auto& mod : loaded_modules) {
+        install_loader_api(mod);
+    }
+
+    // Every module is now in its final state, save it before write protection.
+    // GOT slots bound to lazy stubs point into memory a snapshot cannot restore,
+    // and IFUNC choices depend on the CPU of the run that made them
+    if (!options.snapshot_dir.empty() && lazy_symbols.empty() && ifunc_fixups.empty()) {
+        write_snapshot(loaded_modules.front().obj, options);
+    }
+
+    // 4. Set Permissions (after all relocations are done)
+    for (const auto& mod : loaded_modules) {
+        protect_module(mod);
+    }
+
+    // 5. Run IFUNC resolvers, which need executable code
+    apply_ifunc_fixups();
+}
+
+// Transfer control to the program. The FLE _start never returns; it leaves
+// through the exit syscall.
+[[noreturn]] void run_entry(uint64_t entry)
+{
     using FuncType = int (*)();
     // Entry is VMA. Main EXE base is 0. So entry is absolute.
-    FuncType func = reinterpret_cast<FuncType>(obj.entry);
+    FuncType func = reinterpret_cast<FuncType>(entry);
+    enter_program_tls();
     func();
 
     // Should not reach here
     assert(false);
+    _exit(1);
+}
+
+// ================= Fork server (exec --fork-server FD) =================
+//
+// The program is loaded and relocated once, then every request on the control
+// socket forks a child that starts at the entry point with the image already in
+// place. The protocol on the AF_UNIX control socket is:
+//   server -> client  "FLE!"                      once, when the program is ready
+//   client -> server  1 byte + SCM_RIGHTS fds    fds are stdin, stdout, stderr
+//                                                 (any prefix; missing ones are inherited)
+//   server -> client  int32 pid, int32 status    raw waitpid() status of the run
+// The server exits when the client closes the socket.
+
+constexpr char FORK_SERVER_HELLO[4] = { 'F', 'L', 'E', '!' };
+constexpr size_t FORK_SERVER_MAX_FDS = 3;
+
+bool write_all(int fd, const void* buf, size_t len)
+{
+    const char* p = static_cast<const char*>(buf);
+    while (len > 0) {
+        ssize_t n = write(fd, p, len);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return false;
+        p += n;
+        len -= n;
+    }
+    return true;
+}
+
+// Receive one request. Returns false on EOF; received fds are stored in fds.
+bool receive_request(int ctl_fd, std::vector<int>& fds)
+{
+    char byte;
+    iovec iov { &byte, 1 };
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int) * FORK_SERVER_MAX_FDS)];
+    msghdr msg {};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+
+    ssize_t n;
+    do {
+        n = recvmsg(ctl_fd, &msg, MSG_CMSG_CLOEXEC);
+    } while (n < 0 && errno == EINTR);
+    if (n < 0)
+        throw std::runtime_error(std::string("fork server: recvmsg failed: ") + strerror(errno));
+    if (n == 0)
+        return false;
+
+    fds.clear();
+    for (cmsghdr* c = CMSG_FIRSTHDR(&msg); c != nullptr; c = CMSG_NXTHDR(&msg, c)) {
+        if (c->cmsg_level != SOL_SOCKET || c->cmsg_type != SCM_RIGHTS)
+            continue;
+        size_t count = (c->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+        const int* data = reinterpret_cast<const int*>(CMSG_DATA(c));
+        fds.insert(fds.end(), data, data + count);
+    }
+    return true;
+}
+
+void serve_forks(int ctl_fd, uint64_t entry)
+{
+    if (!write_all(ctl_fd, FORK_SERVER_HELLO, sizeof(FORK_SERVER_HELLO))) {
+        throw std::runtime_error("fork server: control socket closed");
+    }
+
+    std::vector<int> fds;
+    while (receive_request(ctl_fd, fds)) {
+        pid_t pid = fork();
+        if (pid < 0) {
+            throw std::runtime_error(std::string("fork server: fork failed: ") + strerror(errno));
+        }
+        if (pid == 0) {
+            for (size_t i = 0; i < fds.size() && i < FORK_SERVER_MAX_FDS; i++) {
+                dup2(fds[i], static_cast<int>(i));
+            }
+            for (int fd : fds) {
+                if (fd > 2)
+                    close(fd);
+            }
+            close(ctl_fd);
+            run_entry(entry);
+        }
+
+        for (int fd : fds) {
+            close(fd);
+        }
+        int status = 0;
+        while (waitpid(pid, &status, 0) < 0 && errno == EINTR) {
+        }
+        int32_t reply[2] = { static_cast<int32_t>(pid), static_cast<int32_t>(status) };
+        if (!write_all(ctl_fd, reply, sizeof(reply)))
+            break;
+    }
+}
+
+// ================= Supervised runs =================
+//
+// The program leaves through the exit syscall, so the loader never regains
+// control in its process. Modes that report at exit run the program in a
+// forked child, keep their data in MAP_SHARED memory and read it in the
+// parent once the child is gone.
+
+// Run the program in a child and return its raw wait status
+int run_supervised(uint64_t entry, const std::function<void()>& child_setup)
+{
+    std::cout.flush();
+    std::cerr.flush();
+    pid_t pid = fork();
+    if (pid < 0) {
+        throw std::runtime_error(std::string("fork failed: ") + strerror(errno));
+    }
+    if (pid == 0) {
+        child_setup();
+        run_entry(entry);
+    }
+
+    // Ctrl-C is for the program; the report is still written afterwards
+    signal(SIGINT, SIG_IGN);
+    int status = 0;
+    while (waitpid(pid, &status, 0) < 0 && errno == EINTR) {
+    }
+    return status;
+}
+
+// Leave the way the child did
+[[noreturn]] void exit_like(int status)
+{
+    if (WIFSIGNALED(status)) {
+        signal(WTERMSIG(status), SIG_DFL);
+        raise(WTERMSIG(status));
+        _exit(128 + WTERMSIG(status));
+    }
+    _exit(WEXITSTATUS(status));
+}
+
+// Owner of an address, for reports: "symbol", "module+0xoffset" or "[unknown]".
+// Only symbols the modules export are known, and an address belongs to one
+// only within [start, start + size). Static functions and symbols without a
+// size therefore show up as module+0xoffset.
+class Symbolizer {
+public:
+    Symbolizer()
+    {
+        ensure_module_table();
+        for (const auto& mod : loaded_modules) {
+            if (mod.unloaded)
+                continue;
+            ModuleSpan span = module_span(mod.obj);
+            modules_.push_back({ mod.load_base + span.start, mod.load_base + span.end, mod.name });
+            for (const auto& phdr : mod.obj.phdrs) {
+                auto it = mod.obj.sections.find(phdr.name);
+                if (phdr.size > 0 && it != mod.obj.sections.end() && !it->second.data.empty())
+                    segments_.push_back({ mod.load_base + phdr.vaddr, &it->second.data });
+            }
+            for (const auto& sym : mod.obj.symbols) {
+                if (sym.type != SymbolType::GLOBAL && sym.type != SymbolType::WEAK)
+                    continue;
+                auto it = mod.section_addrs.find(sym.section);
+                if (it != mod.section_addrs.end()) {
+                    uint64_t addr = it->second + sym.offset;
+                    symbols_.push_back({ addr, addr + sym.size, sym.name });
+                }
+            }
+        }
+        std::sort(symbols_.begin(), symbols_.end(), [](const Range& a, const Range& b) { return a.start < b.start; });
+    }
+
+    // Start of the symbol containing addr, 0 if none does
+    uint64_t start(uint64_t addr) const
+    {
+        const Range* sym = find(addr);
+        return sym ? sym->start : 0;
+    }
+
+    // The n bytes at addr as stored in the module's file, nullptr outside its
+    // contents. Modules the program loaded later are not mapped in the parent
+    const uint8_t* bytes(uint64_t addr, size_t n) const
+    {
+        for (const auto& seg : segments_) {
+            if (addr >= seg.start && addr - seg.start + n <= seg.data->size())
+                return seg.data->data() + (addr - seg.start);
+        }
+        return nullptr;
+    }
+
+    std::string name(uint64_t addr) const
+    {
+        if (const Range* sym = find(addr)) {
+            return sym->name;
+        }
+        for (const auto& mod : modules_) {
+            if (addr >= mod.start && addr < mod.end) {
+                std::ostringstream out;
+                out << mod.name << "+0x" << std::hex << addr - mod.start;
+                return out.str();
+            }
+        }
+        return "[unknown]";
+    }
+
+private:
+    struct Range {
+        uint64_t start;
+        uint64_t end;
+        std::string name;
+    };
+
+    const Range* find(uint64_t addr) const
+    {
+        auto it = std::upper_bound(symbols_.begin(), symbols_.end(), addr, [](uint64_t a, const Range& r) { return a < r.start; });
+        if (it != symbols_.begin() && addr < std::prev(it)->end) {
+            return &*std::prev(it);
+        }
+        return nullptr;
+    }
+
+    struct Segment {
+        uint64_t start;
+        const std::vector<uint8_t>* data;
+    };
+
+    std::vector<Range> symbols_;
+    std::vector<Range> modules_;
+    std::vector<Segment> segments_;
+};
+
+// ================= Sampling profiler (exec --profile FILE) =================
+//
+// An ITIMER_PROF timer delivers SIGPROF every PROFILE_INTERVAL_US of CPU
+// time. The handler records the interrupted RIP, the top two stack words and
+// the return addresses found by following the frame pointer chain (complete
+// only for code built with -fno-omit-frame-pointer) into a shared ring buffer. Claiming a slot is
+// a single atomic increment, so the handler never blocks; once the ring
+// wraps the oldest samples are overwritten. After the program exits the
+// parent symbolizes the samples and writes a flat profile (JSON) and
+// collapsed stacks for flame graph tools.
+//
+// Libraries the program loads later (fle_dlopen, lazy binding) exist only in
+// the child. load_at_runtime records each of them in the ring, and the parent
+// adds them to its module table before symbolizing.
+
+constexpr long PROFILE_INTERVAL_US = 1000;
+constexpr size_t PROFILE_MAX_DEPTH = 32;
+constexpr size_t PROFILE_CAPACITY = 1 << 15;
+constexpr size_t PROFILE_MAX_LOADS = 64;
+
+struct ProfileSample {
+    uint32_t depth;
+    uint64_t stack[2]; // Top of the stack, holds the return address while no frame is set up
+    uint64_t pcs[PROFILE_MAX_DEPTH]; // Interrupted RIP, then return addresses
+};
+
+// A module loaded by the program after startup
+struct ProfileLoad {
+    uint64_t load_base;
+    char name[256];
+    char path[PATH_MAX];
+};
+
+struct ProfileRing {
+    std::atomic<uint64_t> taken; // Samples taken so far; the next goes to taken % capacity
+    uint64_t stack_top; // Frame pointers must stay below this
+    uint32_t load_count; // Loads in load order; further loads are not recorded
+    ProfileLoad loads[PROFILE_MAX_LOADS];
+    ProfileSample samples[PROFILE_CAPACITY];
+};
+
+ProfileRing* profile_ring = nullptr;
+
+// Top of the main thread's stack, which the program runs on
+uint64_t main_stack_top()
+{
+    std::ifstream maps("/proc/self/maps");
+    std::string line;
+    while (std::getline(maps, line)) {
+        if (ends_with(line, "[stack]")) {
+            return std::stoull(line.substr(line.find('-') + 1), nullptr, 16);
+        }
+    }
+    return 0;
+}
+
+// Async-signal-safe: touches only the ring and the interrupted stack
+void profile_handler(int, siginfo_t*, void* ctx)
+{
+    const auto& gregs = static_cast<ucontext_t*>(ctx)->uc_mcontext.gregs;
+    uint64_t index = profile_ring->taken.fetch_add(1, std::memory_order_relaxed);
+    ProfileSample& sample = profile_ring->samples[index % PROFILE_CAPACITY];
+
+    sample.pcs[0] = gregs[REG_RIP];
+    uint32_t depth = 1;
+    uint64_t low = gregs[REG_RSP];
+    sample.stack[0] = low + 8 <= profile_ring->stack_top ? reinterpret_cast<const uint64_t*>(low)[0] : 0;
+    sample.stack[1] = low + 16 <= profile_ring->stack_top ? reinterpret_cast<const uint64_t*>(low)[1] : 0;
+    uint64_t rbp = gregs[REG_RBP];
+    // Each frame must lie above the previous one on the stack, which also
+    // stops the walk at garbage left in %rbp by code without frame pointers
+    while (depth < PROFILE_MAX_DEPTH && rbp >= low && rbp % 8 == 0 && rbp + 16 <= profile_ring->stack_top) {
+        const uint64_t* frame = reinterpret_cast<const uint64_t*>(rbp);
+        if (frame[1] == 0)
+            break;
+        sample.pcs[depth++] = frame[1];
+        low = rbp + 16;
+        rbp = frame[0];
+    }
+    sample.depth = depth;
+}
+
+// Runs in the child, outside the signal handler
+void record_runtime_load(const LoadedModule& mod)
+{
+    if (profile_ring == nullptr || profile_ring->load_count >= PROFILE_MAX_LOADS
+        || mod.name.size() >= sizeof(ProfileLoad::name) || mod.path.size() >= sizeof(ProfileLoad::path)) {
+        return;
+    }
+    ProfileLoad& load = profile_ring->loads[profile_ring->load_count++];
+    load.load_base = mod.load_base;
+    memcpy(load.name, mod.name.c_str(), mod.name.size() + 1);
+    memcpy(load.path, mod.path.c_str(), mod.path.size() + 1);
+}
+
+// Add the modules the child loaded after startup to the parent's module
+// table; the Symbolizer reads their symbols like those of restored modules
+void add_runtime_loads()
+{
+    for (uint32_t i = 0; i < profile_ring->load_count; i++) {
+        const ProfileLoad& load = profile_ring->loads[i];
+        LoadedModule mod;
+        mod.name = load.name;
+        mod.path = load.path;
+        mod.load_base = load.load_base;
+        mod.dynamic = true;
+        mod.needs_parse = true;
+        loaded_modules.push_back(std::move(mod));
+    }
+}
+
+void start_profiling()
+{
+    struct sigaction sa {};
+    sa.sa_sigaction = profile_handler;
+    sa.sa_flags = SA_SIGINFO | SA_RESTART;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGPROF, &sa, nullptr);
+
+    itimerval timer {};
+    timer.it_interval.tv_usec = PROFILE_INTERVAL_US;
+    timer.it_value.tv_usec = PROFILE_INTERVAL_US;
+    setitimer(ITIMER_PROF, &timer, nullptr);
+}
+
+// Return address of the sampled function when the frame pointer chain skips
+// it, 0 otherwise. That is the case in functions without the standard
+// `push %rbp; mov %rsp, %rbp` prologue (leaf functions usually omit it), and
+// in framed functions before the prologue completes or at their final ret.
+uint64_t unframed_return(const ProfileSample& sample, const Symbolizer& symbolizer)
+{
+    static const uint8_t PROLOGUE[] = { 0x55, 0x48, 0x89, 0xe5 };
+    uint64_t rip = sample.pcs[0];
+    uint64_t start = symbolizer.start(rip);
+    const uint8_t* code = start != 0 ? symbolizer.bytes(start, sizeof(PROLOGUE)) : nullptr;
+    if (code == nullptr) {
+        return 0;
+    }
+    if (memcmp(code, PROLOGUE, sizeof(PROLOGUE)) != 0 || rip == start) {
+        return sample.stack[0];
+    }
+    if (rip == start + 1) {
+        return sample.stack[1]; // %rbp pushed, not yet switched
+    }
+    const uint8_t* insn = symbolizer.bytes(rip, 1);
+    if (insn != nullptr && *insn == 0xc3) {
+        return sample.stack[0]; // Frame already popped
+    }
+    return 0;
+}
+
+// Collapsed stacks and the symbol order go next to the JSON report:
+// out.json -> out.folded, out.order
+std::string profile_sibling(const std::string& json_path, const std::string& extension)
+{
+    std::filesystem::path path(json_path);
+    return path.extension() == ".json" ? path.replace_extension(extension).string() : json_path + extension;
+}
+
+void write_profile(const std::string& path)
+{
+    uint64_t taken = profile_ring->taken.load();
+    uint64_t kept = std::min<uint64_t>(taken, PROFILE_CAPACITY);
+    add_runtime_loads();
+    Symbolizer symbolizer;
+
+    struct FunctionCounts {
+        uint64_t self = 0;
+        uint64_t total = 0;
+    };
+    std::map<std::string, FunctionCounts> functions;
+    std::map<std::string, uint64_t> stacks;
+    std::unordered_map<uint64_t, std::string> names;
+    auto name_of = [&](uint64_t pc) -> const std::string& {
+        auto it = names.find(pc);
+        if (it == names.end())
+            it = names.emplace(pc, symbolizer.name(pc)).first;
+        return it->second;
+    };
+
+    for (uint64_t i = taken - kept; i < taken; i++) {
+        const ProfileSample& sample = profile_ring->samples[i % PROFILE_CAPACITY];
+        std::vector<std::string> frames;
+        for (uint32_t d = 0; d < sample.depth; d++) {
+            // Return addresses point after the call; look up the call itself
+            frames.push_back(name_of(d == 0 ? sample.pcs[d] : sample.pcs[d] - 1));
+            if (d == 0) {
+                uint64_t caller = unframed_return(sample, symbolizer);
+                if (caller != 0)
+                    frames.push_back(name_of(caller - 1));
+            }
+        }
+        // The outermost return address leads back into the loader
+        while (frames.size() > 1 && frames.back() == "[unknown]") {
+            frames.pop_back();
+        }
+        functions[frames[0]].self++;
+        std::set<std::string> seen;
+        for (const auto& frame : frames) {
+            if (seen.insert(frame).second)
+                functions[frame].total++;
+        }
+        std::string stack;
+        for (auto it = frames.rbegin(); it != frames.rend(); ++it) {
+            if (!stack.empty())
+                stack += ';';
+            stack += *it;
+        }
+        stacks[stack]++;
+    }
+
+    std::vector<std::pair<std::string, FunctionCounts>> flat(functions.begin(), functions.end());
+    std::sort(flat.begin(), flat.end(), [](const auto& a, const auto& b) {
+        return a.second.self != b.second.self ? a.second.self > b.second.self : a.second.total > b.second.total;
+    });
+    json report;
+    report["interval_us"] = PROFILE_INTERVAL_US;
+    report["samples"] = kept;
+    report["lost"] = taken - kept;
+    json entries = json::array();
+    for (const auto& [name, counts] : flat) {
+        entries.push_back({
+            { "name", name },
+            { "self", counts.self },
+            { "total", counts.total },
+            { "self_percent", kept ? 100.0 * counts.self / kept : 0.0 },
+        });
+    }
+    report["functions"] = entries;
+    std::ofstream(path) << report.dump(4) << "\n";
+
+    std::ofstream folded(profile_sibling(path, ".folded"));
+    for (const auto& [stack, count] : stacks) {
+        folded << stack << " " << count << "\n";
+    }
+
+    // Hottest first, ready for ld --symbol-ordering-file. Addresses without a
+    // symbol cannot be ordered and are left out
+    std::ofstream order(profile_sibling(path, ".order"));
+    order << "# ld --symbol-ordering-file, " << kept << " samples\n";
+    for (const auto& [name, counts] : flat) {
+        if (name != "[unknown]" && name.find("+0x") == std::string::npos)
+            order << name << "\n";
+    }
+}
+
+void prepare_profile_ring()
+{
+    void* mem = mmap(NULL, sizeof(ProfileRing), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (mem == MAP_FAILED) {
+        throw std::runtime_error(std::string("Failed to map the profile buffer: ") + strerror(errno));
+    }
+    profile_ring = static_cast<ProfileRing*>(mem);
+    profile_ring->taken.store(0);
+    profile_ring->stack_top = main_stack_top();
+    profile_ring->load_count = 0;
+}
+
+// ================= PLT call counting (exec --count-plt) =================
+//
+// Every GOT slot of the executable that holds the address of a function in a
+// shared library is pointed at a trampoline generated for its symbol:
+//   lock incq counter(%rip); jmp *target(%rip)
+// The counter and target cells live behind the trampolines in the same
+// MAP_SHARED mapping, so the parent reads the counts after the child exits.
+// Slots bound to a lazy stub keep counting after binding: fle_lazy_bind
+// patches the trampoline's target cell instead of the slot.
+
+constexpr size_t COUNT_STUB_SIZE = 16;
+
+struct PltCounter {
+    std::string symbol;
+    const uint64_t* calls;
+};
+
+std::vector<PltCounter> plt_counters;
+
+// True if addr is inside an executable segment of a shared library or a lazy
+// binding stub
+bool is_imported_code(uint64_t addr)
+{
+    if (lazy_arena != 0 && addr >= lazy_arena && addr < lazy_arena + lazy_symbols.size() * LAZY_STUB_SIZE)
+        return true;
+    for (const auto& mod : loaded_modules) {
+        if (mod.unloaded || &mod == &loaded_modules.front())
+            continue;
+        for (const auto& phdr : mod.obj.phdrs) {
+            uint64_t start = mod.load_base + phdr.vaddr;
+            if ((phdr.flags & PHF::X) && addr >= start && addr < start + phdr.size)
+                return true;
+        }
+    }
+    return false;
+}
+
+void install_plt_counters()
+{
+    const LoadedModule& exe = loaded_modules.front();
+    std::map<std::string, std::vector<uint64_t>> slots; // Symbol -> GOT slots
+    for (const auto& reloc : exe.obj.dyn_relocs) {
+        if (reloc.type != RelocationType::R_X86_64_64 && reloc.type != RelocationType::R_X86_64_IRELATIVE)
+            continue;
+        if (is_imported_code(*reinterpret_cast<const uint64_t*>(reloc.offset)))
+            slots[reloc.symbol].push_back(reloc.offset);
+    }
+    if (slots.empty())
+        return;
+
+    size_t code_size = page_up(slots.size() * COUNT_STUB_SIZE);
+    size_t size = code_size + page_up(slots.size() * 2 * sizeof(uint64_t));
+    void* mem = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (mem == MAP_FAILED) {
+        throw std::runtime_error(std::string("Failed to map PLT counters: ") + strerror(errno));
+    }
+    uint8_t* code = static_cast<uint8_t*>(mem);
+    uint64_t* cells = reinterpret_cast<uint64_t*>(code + code_size); // { count, target } per symbol
+
+    std::unordered_map<uint64_t, uint64_t> target_cell; // GOT slot -> target cell
+    size_t i = 0;
+    for (const auto& [symbol, sym_slots] : slots) {
+        uint8_t* stub = code + i * COUNT_STUB_SIZE;
+        uint64_t* count = &cells[2 * i];
+        uint64_t* target = &cells[2 * i + 1];
+        *target = *reinterpret_cast<const uint64_t*>(sym_slots.front());
+
+        int32_t count_disp = static_cast<int32_t>(reinterpret_cast<uint8_t*>(count) - (stub + 8));
+        int32_t target_disp = static_cast<int32_t>(reinterpret_cast<uint8_t*>(target) - (stub + 14));
+        const uint8_t lock_incq[] = { 0xf0, 0x48, 0xff, 0x05 }; // lock incq disp32(%rip)
+        memcpy(stub, lock_incq, sizeof(lock_incq));
+        memcpy(stub + 4, &count_disp, sizeof(count_disp));
+        const uint8_t jmp[] = { 0xff, 0x25 }; // jmp *disp32(%rip)
+        memcpy(stub + 8, jmp, sizeof(jmp));
+        memcpy(stub + 10, &target_disp, sizeof(target_disp));
+        memset(stub + 14, 0xcc, COUNT_STUB_SIZE - 14);
+
+        for (uint64_t slot : sym_slots) {
+            int prot = page_prot_at(exe, slot);
+            void* page = reinterpret_cast<void*>(page_down(slot));
+            size_t len = page_up(slot + sizeof(uint64_t)) - page_down(slot);
+            if (!(prot & PROT_WRITE))
+                mprotect(page, len, prot | PROT_WRITE);
+            *reinterpret_cast<uint64_t*>(slot) = reinterpret_cast<uint64_t>(stub);
+            if (!(prot & PROT_WRITE))
+                mprotect(page, len, prot);
+            target_cell[slot] = reinterpret_cast<uint64_t>(target);
+        }
+        plt_counters.push_back({ symbol, count });
+        i++;
+    }
+    mprotect(mem, code_size, PROT_READ | PROT_EXEC);
+
+    for (auto& lazy : lazy_symbols) {
+        for (uint64_t& slot : lazy.slots) {
+            auto it = target_cell.find(slot);
+            if (it != target_cell.end())
+                slot = it->second;
+        }
+    }
+}
+
+void report_plt_counts()
+{
+    std::vector<std::pair<uint64_t, std::string>> rows;
+    uint64_t total = 0;
+    for (const auto& counter : plt_counters) {
+        rows.emplace_back(*counter.calls, counter.symbol);
+        total += *counter.calls;
+    }
+    std::sort(rows.begin(), rows.end(), [](const auto& a, const auto& b) {
+        return a.first != b.first ? a.first > b.first : a.second < b.second;
+    });
+
+    std::ostringstream out;
+    out << "FLE PLT call counts:\n";
+    for (const auto& [calls, symbol] : rows) {
+        out << "  " << std::setw(12) << calls << "  " << symbol << "\n";
+    }
+    out << "  " << std::setw(12) << total << "  (total)\n";
+    std::cerr << out.str() << std::flush;
+}
+
+// Run the program under supervision and write the reports requested in
+// options once it has exited
+[[noreturn]] void run_reporting(uint64_t entry, const ExecOptions& options)
+{
+    bool profile = !options.profile_path.empty();
+    if (profile) {
+        prepare_profile_ring();
+    }
+    int status = run_supervised(entry, [profile]() {
+        if (profile)
+            start_profiling();
+    });
+    if (profile) {
+        write_profile(options.profile_path);
+    }
+    if (options.count_plt) {
+        report_plt_counts();
+    }
+    exit_like(status);
+}
+
+} // namespace
+
+void FLE_exec(FLEObject obj, const ExecOptions& options)
+{
+    if (obj.type != ".exe") {
+        throw std::runtime_error("File is not an executable FLE.");
+    }
+    bool reporting = !options.profile_path.empty() || options.count_plt;
+    if (reporting && options.fork_server_fd >= 0) {
+        throw std::runtime_error("--profile and --count-plt cannot be combined with --fork-server");
+    }
+
+    init_stats();
+    if (stats.enabled) {
+        stats.vmas_before = count_vmas();
+    }
+
+    uint64_t entry = obj.entry;
+    if (!options.snapshot_dir.empty() && restore_snapshot(obj, options)) {
+        for (auto& mod : loaded_modules) {
+            install_loader_api(mod);
+        }
+        // PLT counting and profiling walk the segments and symbols of every
+        // dependency, which a restored module has not read yet
+        if (reporting) {
+            ensure_module_table();
+        }
+    } else {
+        load_program(std::move(obj), options);
+    }
+
+    setup_static_tls(loaded_modules.front().obj);
+    if (options.count_plt) {
+        install_plt_counters();
+    }
+
+    if (stats.enabled) {
+        stats.vmas_after = count_vmas();
+        report_stats();
+    }
+
+    if (options.fork_server_fd >= 0) {
+        serve_forks(options.fork_server_fd, entry);
+        return;
+    }
+
+    if (reporting) {
+        run_reporting(entry, options);
+    }
+
+    // 4. Jump to Entry
+    run_entry(entry);
 }
@@ -8,6 +8,7 @@
 #include <fstream>
 #include <iostream>
 #include <regex>
+#include <sstream>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -72,6 +73,8 @@ static void parse_program_headers(const json& j, FLEObject& obj)
             phdr.vaddr = phdr_json["vaddr"].get<uint64_t>();
             phdr.size = phdr_json["size"].get<uint32_t>();
             phdr.flags = phdr_json["flags"].get<uint32_t>();
+            phdr.offset = phdr_json.value("offset", uint64_t(0));
+            phdr.filesz = phdr_json.value("filesz", uint64_t(0));
             obj.phdrs.push_back(phdr);
         }
     }
@@ -89,6 +92,8 @@ static void parse_section_headers(const json& j, FLEObject& obj)
             shdr.addr = shdr_json["addr"].get<uint64_t>();
             shdr.offset = shdr_json["offset"].get<uint64_t>();
             shdr.size = shdr_json["size"].get<uint64_t>();
+            shdr.entsize = shdr_json.value("entsize", uint64_t { 0 });
+            shdr.addralign = shdr_json.value("addralign", uint64_t { 1 });
             obj.shdrs.push_back(shdr);
         }
     }
@@ -107,6 +112,14 @@ static RelocationType parse_relocation_type(const std::string& type_str)
         return RelocationType::R_X86_64_32S;
     if (type_str == "gotpcrel")
         return RelocationType::R_X86_64_GOTPCREL;
+    if (type_str == "gotpcrelx")
+        return RelocationType::R_X86_64_GOTPCRELX;
+    if (type_str == "dynirel")
+        return RelocationType::R_X86_64_IRELATIVE;
+    if (type_str == "tpoff")
+        return RelocationType::R_X86_64_TPOFF32;
+    if (type_str == "gottpoff")
+        return RelocationType::R_X86_64_GOTTPOFF;
     throw std::runtime_error("Invalid relocation type: " + type_str);
 }
 static int64_t parse_addend_literal(std::string literal)
@@ -167,6 +180,16 @@ static FLEObject parse_fle_from_json(const json& j, const std::string& name)
             obj.needed.push_back(lib.get<std::string>());
         }
     }
+    if (j.contains("lazy")) {
+        obj.lazy = j["lazy"].get<std::map<std::string, std::vector<std::string>>>();
+    }
+    if (j.contains("tls")) {
+        const auto& tls = j["tls"];
+        obj.tls.vaddr = tls["vaddr"].get<uint64_t>();
+        obj.tls.filesz = tls["filesz"].get<uint64_t>();
+        obj.tls.memsz = tls["memsz"].get<uint64_t>();
+        obj.tls.align = tls["align"].get<uint64_t>();
+    }
 
     std::vector<Relocation> legacy_dyn_relocs;
     std::vector<Relocation> inline_dyn_relocs;
@@ -185,7 +208,7 @@ static FLEObject parse_fle_from_json(const json& j, const std::string& name)
 
     // 第一遍：收集所有符号定义并计算偏移量
     for (auto& [key, value] : j.items()) {
-        if (key == "type" || key == "entry" || key == "phdrs" || key == "shdrs" || key == "members" || key == "name" || key == "needed" || key == "dyn_relocs")
+        if (key == "type" || key == "entry" || key == "phdrs" || key == "shdrs" || key == "members" || key == "name" || key == "needed" || key == "lazy" || key == "tls" || key == "dyn_relocs")
             continue;
 
         // size_t current_offset = 0;
@@ -195,7 +218,7 @@ static FLEObject parse_fle_from_json(const json& j, const std::string& name)
             std::string prefix = line_str.substr(0, colon_pos);
             std::string content = line_str.substr(colon_pos + 1);
 
-            if (prefix == "🏷️" || prefix == "📎" || prefix == "📤") {
+            if (prefix == "🏷️" || prefix == "📎" || prefix == "📤" || prefix == "🔀") {
                 std::string name;
                 size_t size, offset;
                 std::istringstream ss(content);
@@ -210,7 +233,8 @@ static FLEObject parse_fle_from_json(const json& j, const std::string& name)
                     std::string(key),
                     offset,
                     size,
-                    name
+                    name,
+                    prefix == "🔀"
                 };
 
                 symbol_table[name] = sym;
@@ -221,7 +245,7 @@ static FLEObject parse_fle_from_json(const json& j, const std::string& name)
 
     // 第二遍：处理节的内容和重定位
     for (auto& [key, value] : j.items()) {
-        if (key == "type" || key == "entry" || key == "phdrs" || key == "shdrs" || key == "members" || key == "name" || key == "needed" || key == "dyn_relocs")
+        if (key == "type" || key == "entry" || key == "phdrs" || key == "shdrs" || key == "members" || key == "name" || key == "needed" || key == "lazy" || key == "tls" || key == "dyn_relocs")
             continue;
 
         FLESection section;
@@ -241,7 +265,7 @@ static FLEObject parse_fle_from_json(const json& j, const std::string& name)
                 }
             } else if (prefix == "❓") {
                 std::string reloc_str = trim(content);
-                std::regex reloc_pattern(R"(\.(rel|abs64|abs|abs32s|gotpcrel|dynrel|dynabs64|dynabs32)\(([\w.@$]+)\s*([-+])\s*([0-9a-fA-FxX]+)\))");
+                std::regex reloc_pattern(R"(\.(rel|abs64|abs|abs32s|gotpcrelx|gotpcrel|tpoff|gottpoff|dynrel|dynabs64|dynabs32|dynirel)\(([\w.@$]+)\s*([-+])\s*([0-9a-fA-FxX]+)\))");
                 std::smatch match;
 
                 if (!std::regex_match(reloc_str, match, reloc_pattern)) {
@@ -289,7 +313,7 @@ static FLEObject parse_fle_from_json(const json& j, const std::string& name)
 
                     inline_dyn_relocs.push_back(reloc);
 
-                    size_t size = (type == RelocationType::R_X86_64_64) ? 8 : 4;
+                    size_t size = (type == RelocationType::R_X86_64_64 || type == RelocationType::R_X86_64_IRELATIVE) ? 8 : 4;
                     section.data.insert(section.data.end(), size, 0);
                     continue;
                 }
@@ -308,7 +332,7 @@ static FLEObject parse_fle_from_json(const json& j, const std::string& name)
                 // 根据重定位类型预留空间
                 size_t size = (type == RelocationType::R_X86_64_64) ? 8 : 4;
                 section.data.insert(section.data.end(), size, 0);
-            } else if (prefix == "🏷️" || prefix == "📎" || prefix == "📤") {
+            } else if (prefix == "🏷️" || prefix == "📎" || prefix == "📤" || prefix == "🔀") {
                 section.has_symbols = true;
             }
         }
@@ -332,12 +356,22 @@ FLEObject load_fle(const std::string& file)
     std::string content((std::istreambuf_iterator<char>(infile)),
         std::istreambuf_iterator<char>());
 
+    // 二进制段布局：JSON 以 NUL 结尾，其后下一页开始是段镜像
+    uint64_t image_base = 0;
+    size_t nul = content.find('\0');
+    if (nul != std::string::npos) {
+        image_base = (nul + 1 + FLE_IMAGE_ALIGN - 1) / FLE_IMAGE_ALIGN * FLE_IMAGE_ALIGN;
+        content.resize(nul);
+    }
+
     if (content.substr(0, 2) == "#!") {
         content = content.substr(content.find('\n') + 1);
     }
 
     json j = json::parse(content);
-    return parse_fle_from_json(j, get_basename(file));
+    FLEObject obj = parse_fle_from_json(j, get_basename(file));
+    obj.image_base = image_base;
+    return obj;
 }
 
 /**
@@ -434,6 +468,7 @@ struct InputItem {
     enum Type { File,
         Library } type;
     std::string value;
+    bool lazy = false; // 出现在 -z lazyload 之后
 };
 
 int main(int argc, char* argv[])
@@ -461,7 +496,7 @@ int main(int argc, char* argv[])
                   << "  objdump <input>                  Display contents of FLE file\n"
                   << "  nm <input>                       Display symbol table\n"
                   << "  ld [-o output] input1 input2...  Link FLE files (.fo/.fa/.fle)\n"
-                  << "  exec <input.fle>                 Execute FLE file\n"
+                  << "  exec [options] <input.fle>       Execute FLE file\n"
                   << "  cc [-o output.o] input.c...      Compile C files (outputs .fo)\n"
                   << "  ar <output.fa> <input.fo>...     Create static archive\n"
                   << "  readfle <input>                  Display FLE file information\n"
@@ -486,10 +521,37 @@ int main(int argc, char* argv[])
             }
             FLE_nm(load_fle(args[0]));
         } else if (tool == "FLE_exec") {
-            if (args.size() != 1) {
-                throw std::runtime_error("Usage: exec <input.fle>");
+            ExecOptions options;
+            std::vector<std::string> inputs;
+
+            ArgParser parser("exec");
+
+            parser.add_option_cb("--fork-server", "Serve run requests on control socket FD", [&](std::string fd) {
+                options.fork_server_fd = std::stoi(fd);
+            });
+            parser.add_option(options.snapshot_dir, "--snapshot-cache", "Reuse relocated images cached in DIR");
+            parser.add_flag(options.huge_pages, "--huge-pages", "Back 2 MiB aligned text with huge pages");
+            parser.add_option_cb("-j, --jobs", "Loader threads (default: one per CPU)", [&](std::string jobs) {
+                options.jobs = static_cast<unsigned>(std::stoul(jobs));
+            });
+            parser.add_option(options.profile_path, "--profile", "Sample the program and write a profile to FILE");
+            parser.add_flag(options.count_plt, "--count-plt", "Count calls through the GOT per imported function");
+
+            parser.on_positional([&](std::string file_path) {
+                inputs.push_back(file_path);
+            });
+
+            try {
+                parser.parse(args);
+            } catch (const ArgParser::HelpRequested&) {
+                return 0;
+            }
+
+            if (inputs.size() != 1) {
+                throw std::runtime_error("Usage: exec [options] <input.fle>");
             }
-            FLE_exec(load_fle(args[0]));
+            options.program_path = inputs[0];
+            FLE_exec(load_fle(inputs[0]), options);
         } else if (tool == "FLE_ld") {
             LinkerOptions options;
             std::vector<InputItem> ordered_inputs;
@@ -501,14 +563,104 @@ int main(int argc, char* argv[])
             parser.add_option(options.entryPoint, "-e, --entry", "Entry point");
             parser.add_flag(options.shared, "-shared", "Create shared library");
             parser.add_flag(options.is_static, "-static", "Static linking");
+            parser.add_flag(options.binary_segments, "--binary-segments", "Append page-aligned segment images for mmap");
+            parser.add_flag(options.huge_text, "--huge-text", "Align and pad .text to 2 MiB for huge pages");
+            parser.add_flag(options.pack_segments, "--pack-segments", "Place .got right after .data and .bss right after .got");
+            parser.add_flag(options.print_stats, "--stats", "Print per-phase link times and PLT/GOT counts");
+            parser.add_flag(options.gc_sections, "--gc-sections", "Drop sections unreachable from the entry point");
+            parser.add_flag(options.print_gc_sections, "--print-gc-sections", "List the sections dropped by --gc-sections");
+            parser.add_option_cb("--icf", "Fold identical code sections (all, safe, none)", [&](std::string mode) {
+                if (mode != "all" && mode != "safe" && mode != "none") {
+                    throw std::runtime_error("Unknown --icf mode: " + mode);
+                }
+                options.icf = mode;
+            });
+            parser.add_flag(options.print_icf_sections, "--print-icf-sections", "List the sections folded by --icf");
+            parser.add_option_cb("--symbol-ordering-file", "Place the sections of the listed symbols first in .text", [&](std::string path) {
+                std::ifstream infile(path);
+                if (!infile) {
+                    throw std::runtime_error("Cannot open symbol ordering file: " + path);
+                }
+                // 每行一个符号名，# 开头的行是注释
+                std::string line;
+                while (std::getline(infile, line)) {
+                    line = trim(line, " \t\r");
+                    if (!line.empty() && line[0] != '#') {
+                        options.symbol_ordering.push_back(line);
+                    }
+                }
+            });
+            // 逗号分隔的组名，必须恰好是 groups 的一个排列
+            auto parse_order = [](const std::string& flag, const std::string& list, std::vector<std::string> groups) {
+                std::vector<std::string> order;
+                std::istringstream in(list);
+                std::string group;
+                while (std::getline(in, group, ',')) {
+                    order.push_back(group);
+                }
+                std::vector<std::string> sorted = order;
+                std::sort(sorted.begin(), sorted.end());
+                std::sort(groups.begin(), groups.end());
+                if (sorted != groups) {
+                    throw std::runtime_error(flag + " must list each of " + join(groups, ",") + " once: " + list);
+                }
+                return order;
+            };
+            parser.add_option_cb("--text-order", "Order of .text groups (default: hot,normal,startup,unlikely)", [&](std::string list) {
+                options.text_order = parse_order("--text-order", list, { "hot", "normal", "startup", "unlikely" });
+            });
+            parser.add_option_cb("--data-order", "Order of .data groups (default: relro,normal)", [&](std::string list) {
+                options.data_order = parse_order("--data-order", list, { "relro", "normal" });
+            });
+            parser.add_flag(options.call_graph_sort, "--call-graph-sort", "Order .text sections by call graph clustering (C3)");
+            parser.add_option_cb("--call-graph-profile", "Weight --call-graph-sort by collapsed stacks (implies --call-graph-sort)", [&](std::string path) {
+                std::ifstream infile(path);
+                if (!infile) {
+                    throw std::runtime_error("Cannot open call graph profile: " + path);
+                }
+                // exec --profile 的折叠栈："main;hot_path;spin 53"，相邻两帧是一次调用
+                std::string line;
+                while (std::getline(infile, line)) {
+                    auto space = line.rfind(' ');
+                    if (space == std::string::npos) {
+                        continue;
+                    }
+                    uint64_t count = std::stoull(line.substr(space + 1));
+                    std::istringstream stack(line.substr(0, space));
+                    std::string caller, callee;
+                    while (std::getline(stack, callee, ';')) {
+                        if (!caller.empty()) {
+                            options.call_graph_profile[{ caller, callee }] += count;
+                        }
+                        caller = callee;
+                    }
+                }
+                options.call_graph_sort = true;
+            });
             parser.add_multi_option(lib_paths, "-L", "Add library search path");
 
+            // -z 关键字：lazyload/nolazyload 作用于其后出现的共享库，separate-code 作用于整个输出
+            bool lazy = false;
+            parser.add_option_cb("-z", "Linker keyword (lazyload, nolazyload, separate-code, noseparate-code)", [&](std::string keyword) {
+                if (keyword == "lazyload") {
+                    lazy = true;
+                } else if (keyword == "nolazyload") {
+                    lazy = false;
+                } else if (keyword == "separate-code") {
+                    options.separate_code = true;
+                } else if (keyword == "noseparate-code") {
+                    options.separate_code = false;
+                } else {
+                    throw std::runtime_error("Unknown -z keyword: " + keyword);
+                }
+            });
+
             parser.add_option_cb("-l", "Link library", [&](std::string lib_name) {
-                ordered_inputs.push_back({ InputItem::Library, lib_name });
+                ordered_inputs.push_back({ InputItem::Library, lib_name, lazy });
             });
 
             parser.on_positional([&](std::string file_path) {
-                ordered_inputs.push_back({ InputItem::File, file_path });
+                ordered_inputs.push_back({ InputItem::File, file_path, lazy });
             });
 
             try {
@@ -535,6 +687,9 @@ int main(int argc, char* argv[])
                     std::string path = find_library(item.value, lib_paths, options.is_static);
                     objects.push_back(load_fle(path));
                 }
+                if (item.lazy && objects.back().type == ".so") {
+                    options.lazy_libs.insert(objects.back().name);
+                }
             }
 
             FLEObject result = FLE_ld(objects, options);
@@ -30,6 +30,24 @@ void FLE_objdump(const FLEObject& obj, FLEWriter& writer)
         if (!obj.needed.empty()) {
             writer.write_needed(obj.needed);
         }
+        if (!obj.lazy.empty()) {
+            writer.write_lazy(obj.lazy);
+        }
+        if (obj.tls.memsz != 0) {
+            writer.write_tls(obj.tls);
+        }
+    }
+
+    // 二进制段布局：段镜像附加在 JSON 之后
+    for (const auto& phdr : obj.phdrs) {
+        if (phdr.filesz == 0) {
+            continue;
+        }
+        auto it = obj.sections.find(phdr.name);
+        if (it == obj.sections.end()) {
+            throw std::runtime_error("Section data not found for segment: " + phdr.name);
+        }
+        writer.add_segment_image(phdr.offset, it->second.data);
     }
 
     // 预处理：构建符号表索引
@@ -129,6 +147,14 @@ void FLE_objdump(const FLEObject& obj, FLEWriter& writer)
                     return dynamic ? ".dynabs32" : ".abs32s";
                 case RelocationType::R_X86_64_GOTPCREL:
                     return dynamic ? ".dyngotpcrel" : ".gotpcrel";
+                case RelocationType::R_X86_64_GOTPCRELX:
+                    return dynamic ? ".dyngotpcrel" : ".gotpcrelx";
+                case RelocationType::R_X86_64_IRELATIVE:
+                    return ".dynirel";
+                case RelocationType::R_X86_64_TPOFF32:
+                    return ".tpoff";
+                case RelocationType::R_X86_64_GOTTPOFF:
+                    return ".gottpoff";
                 }
                 throw std::runtime_error("Unsupported relocation type in objdump");
             };
@@ -138,33 +164,38 @@ void FLE_objdump(const FLEObject& obj, FLEWriter& writer)
             auto abs_addend = static_cast<uint64_t>(std::llabs(entry.reloc.addend));
 
             std::ostringstream ss;
-            ss << "❓: " << tag << "(" << entry.reloc.symbol << " " << sign << " " << abs_addend << ")";
+            // 加数按十六进制写出，与 load_fle 的解析方式一致
+            ss << "❓: " << tag << "(" << entry.reloc.symbol << " " << sign << " 0x" << std::hex << abs_addend << ")";
             return ss.str();
         };
 
+        auto write_symbol = [&](const Symbol& sym) {
+            std::string line;
+            switch (sym.type) {
+            case SymbolType::LOCAL:
+                line = "🏷️: " + sym.name;
+                break;
+            case SymbolType::WEAK:
+                line = "📎: " + sym.name;
+                break;
+            case SymbolType::GLOBAL:
+                line = (sym.ifunc ? "🔀: " : "📤: ") + sym.name;
+                break;
+            default:
+                [[unlikely]] throw std::runtime_error("unknown symbol type");
+            }
+            line += " " + std::to_string(sym.size) + " " + std::to_string(sym.offset);
+            writer.write_line(line);
+        };
+
+        auto section_it = symbol_index.find(name);
         size_t pos = 0;
         while (pos < section.data.size()) {
-            auto section_it = symbol_index.find(name);
             if (section_it != symbol_index.end()) {
                 auto offset_it = section_it->second.find(pos);
                 if (offset_it != section_it->second.end()) {
                     for (const auto& sym : offset_it->second) {
-                        std::string line;
-                        switch (sym.type) {
-                        case SymbolType::LOCAL:
-                            line = "🏷️: " + sym.name;
-                            break;
-                        case SymbolType::WEAK:
-                            line = "📎: " + sym.name;
-                            break;
-                        case SymbolType::GLOBAL:
-                            line = "📤: " + sym.name;
-                            break;
-                        default:
-                            [[unlikely]] throw std::runtime_error("unknown symbol type");
-                        }
-                        line += " " + std::to_string(sym.size) + " " + std::to_string(sym.offset);
-                        writer.write_line(line);
+                        write_symbol(sym);
                     }
                 }
             }
@@ -206,6 +237,15 @@ void FLE_objdump(const FLEObject& obj, FLEWriter& writer)
             }
         }
 
+        // NOBITS 节（如 .bss）没有字节内容，只写出符号，符号行自带偏移
+        if (section_it != symbol_index.end()) {
+            for (auto it = section_it->second.lower_bound(pos); it != section_it->second.end(); ++it) {
+                for (const auto& sym : it->second) {
+                    write_symbol(sym);
+                }
+            }
+        }
+
         writer.end_section();
     }
 }
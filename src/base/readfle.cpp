@@ -54,8 +54,9 @@ void FLE_readfle(const FLEObject& obj)
               << std::left << std::setw(10) << "Size" << "  "
               << std::left << std::setw(20) << "Flags" << "  "
               << std::left << std::setw(10) << "Addr" << "  "
-              << std::left << "Offset" << std::endl;
-    print_separator(max_section_name_len + 55);
+              << std::left << std::setw(10) << "Offset" << "  "
+              << std::left << "Align" << std::endl;
+    print_separator(max_section_name_len + 62);
 
     for (const auto& shdr : obj.shdrs) {
         std::cout << std::setfill(' ');
@@ -72,6 +73,12 @@ void FLE_readfle(const FLEObject& obj)
             flags.push_back("EXEC");
         if (shdr.flags & SHF::NOBITS)
             flags.push_back("NOBITS");
+        if (shdr.flags & SHF::TLS)
+            flags.push_back("TLS");
+        if (shdr.flags & SHF::MERGE)
+            flags.push_back("MERGE");
+        if (shdr.flags & SHF::STRINGS)
+            flags.push_back("STRINGS");
 
         std::string flag_str;
         for (size_t i = 0; i < flags.size(); i++) {
@@ -81,7 +88,8 @@ void FLE_readfle(const FLEObject& obj)
         }
         std::cout << std::left << std::setw(20) << flag_str << "  "
                   << std::left << std::setw(10) << format_hex(shdr.addr, 4) << "  "
-                  << std::left << format_hex(shdr.offset, 2) << std::endl;
+                  << std::left << std::setw(10) << format_hex(shdr.offset, 2) << "  "
+                  << std::left << shdr.addralign << std::endl;
     }
     std::cout << std::endl;
 
@@ -113,7 +121,7 @@ void FLE_readfle(const FLEObject& obj)
             type_str = "WEAK  ";
             break;
         case SymbolType::GLOBAL:
-            type_str = "GLOBAL";
+            type_str = sym.ifunc ? "IFUNC " : "GLOBAL";
             break;
         case SymbolType::UNDEFINED:
             type_str = "UNDEF ";
@@ -159,6 +167,21 @@ void FLE_readfle(const FLEObject& obj)
                 case RelocationType::R_X86_64_32S:
                     type_str = "R_X86_64_32S";
                     break;
+                case RelocationType::R_X86_64_GOTPCREL:
+                    type_str = "R_X86_64_GOTPCREL";
+                    break;
+                case RelocationType::R_X86_64_GOTPCRELX:
+                    type_str = "R_X86_64_GOTPCRELX";
+                    break;
+                case RelocationType::R_X86_64_IRELATIVE:
+                    type_str = "R_X86_64_IRELATIVE";
+                    break;
+                case RelocationType::R_X86_64_TPOFF32:
+                    type_str = "R_X86_64_TPOFF32";
+                    break;
+                case RelocationType::R_X86_64_GOTTPOFF:
+                    type_str = "R_X86_64_GOTTPOFF";
+                    break;
                 }
                 std::cout << std::left << std::setw(15) << type_str
                           << std::left << std::setw(max_symbol_name_len) << reloc.symbol
@@ -1,10 +1,18 @@
 #include "fle.hpp"
 #include <algorithm>
 #include <cassert>
+#include <chrono>
 #include <cstring>
+#include <functional>
+#include <iomanip>
 #include <iostream>
 #include <map>
+#include <mutex>
 #include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
 #include <vector>
 #include <set>
 using namespace std;
@@ -13,23 +21,389 @@ using namespace std;
 constexpr uint64_t BASE_ADDR = 0x400000;
 static inline uint64_t align_up(uint64_t x, uint64_t a) { return (x + a - 1) / a * a; }
 
+// 把 [0, n) 分块交给多个线程执行 fn(i)
+static void parallel_for(size_t n, const function<void(size_t)>& fn)
+{
+    size_t workers = min<size_t>(max(1u, thread::hardware_concurrency()), n);
+    if (workers <= 1) {
+        for (size_t i = 0; i < n; ++i) fn(i);
+        return;
+    }
+    vector<thread> threads;
+    for (size_t w = 0; w < workers; ++w) {
+        threads.emplace_back([&, w] {
+            for (size_t i = w; i < n; i += workers) fn(i);
+        });
+    }
+    for (auto& t : threads) t.join();
+}
+
+// FNV-1a
+static uint64_t hash_bytes(const string& bytes)
+{
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for (unsigned char c : bytes) { h ^= c; h *= 0x100000001b3ULL; }
+    return h;
+}
+
+// 重定位处的指令是否是直接调用/跳转（call/jmp rel32、jcc rel32），而不是取地址
+static bool is_direct_branch(const FLESection& sec, const Relocation& r)
+{
+    if (r.type != RelocationType::R_X86_64_PC32 || r.offset < 1) return false;
+    uint8_t op = sec.data[r.offset - 1];
+    if (op == 0xe8 || op == 0xe9) return true;
+    return r.offset >= 2 && sec.data[r.offset - 2] == 0x0f && op >= 0x80 && op <= 0x8f;
+}
+
+// GOTPCRELX 引用的指令能否在目标位于本模块时改写成直接引用。只改写下面三种形式：
+//   mov foo@GOTPCREL(%rip), %reg  -> lea foo(%rip), %reg
+//   call *foo@GOTPCREL(%rip)      -> addr32 call foo
+//   jmp *foo@GOTPCREL(%rip)       -> jmp foo; nop
+// 汇编器对 cmp、test、add 等运算指令同样生成 GOTPCRELX，这些引用以及普通的 GOTPCREL
+// 都保留 GOT 槽：可执行文件中使用链接时填好的 local_got 槽，共享库中交给加载器
+static bool is_relaxable_gotpcrel(const vector<uint8_t>& code, size_t off, int64_t addend)
+{
+    if (addend != -4 || off < 2 || off + 4 > code.size()) return false;
+    uint8_t op = code[off - 2], modrm = code[off - 1];
+    if (op == 0x8b && (modrm & 0xc7) == 0x05) return true;
+    return op == 0xff && (modrm == 0x15 || modrm == 0x25);
+}
+
+// 按上面的规则改写 off 处的 GOTPCRELX 引用，target 为符号地址，P 为原重定位位置的地址
+static void relax_gotpcrel(vector<uint8_t>& code, size_t off, uint64_t target, uint64_t P)
+{
+    auto put32 = [&](size_t at, int64_t v) {
+        for (int i = 0; i < 4; ++i) code[at + i] = static_cast<uint8_t>((static_cast<uint64_t>(v) >> (8 * i)) & 0xff);
+    };
+    int64_t rel = static_cast<int64_t>(target) - static_cast<int64_t>(P + 4);
+    if (code[off - 2] == 0x8b) {
+        code[off - 2] = 0x8d;
+        put32(off, rel);
+    } else if (code[off - 1] == 0x15) {
+        code[off - 2] = 0x67;
+        code[off - 1] = 0xe8;
+        put32(off, rel);
+    } else {
+        code[off - 2] = 0xe9;
+        put32(off - 1, rel + 1);
+        code[off + 3] = 0x90;
+    }
+}
+
+// 用多字节 NOP 把代码填充到 size 字节，保证跨过填充区执行时每条指令都完整
+static void pad_with_nops(vector<uint8_t>& code, size_t size)
+{
+    static const vector<uint8_t> NOPS[] = {
+        {},
+        { 0x90 },
+        { 0x66, 0x90 },
+        { 0x0f, 0x1f, 0x00 },
+        { 0x0f, 0x1f, 0x40, 0x00 },
+        { 0x0f, 0x1f, 0x44, 0x00, 0x00 },
+        { 0x66, 0x0f, 0x1f, 0x44, 0x00, 0x00 },
+        { 0x0f, 0x1f, 0x80, 0x00, 0x00, 0x00, 0x00 },
+        { 0x0f, 0x1f, 0x84, 0x00, 0x00, 0x00, 0x00, 0x00 },
+        { 0x66, 0x0f, 0x1f, 0x84, 0x00, 0x00, 0x00, 0x00, 0x00 },
+    };
+    while (code.size() < size) {
+        const auto& nop = NOPS[min<size_t>(size - code.size(), 9)];
+        code.insert(code.end(), nop.begin(), nop.end());
+    }
+}
+
+// 分片加锁的并发哈希集合：内容 -> 最早出现的位置。
+// 记录最小位置而不是最先插入者，多线程插入时输出仍然确定
+class ConcurrentStringSet {
+public:
+    void insert(string_view key, uint64_t pos)
+    {
+        Shard& shard = shards_[hash<string_view>{}(key) % SHARDS];
+        lock_guard<mutex> guard(shard.lock);
+        auto [it, inserted] = shard.first.emplace(key, pos);
+        if (!inserted && pos < it->second) it->second = pos;
+    }
+
+    // 按最早出现的位置排序的全部内容
+    vector<string_view> ordered() const
+    {
+        vector<pair<uint64_t, string_view>> all;
+        for (const auto& shard : shards_) {
+            for (const auto& [key, pos] : shard.first) all.emplace_back(pos, key);
+        }
+        sort(all.begin(), all.end());
+        vector<string_view> keys;
+        for (const auto& [pos, key] : all) keys.push_back(key);
+        return keys;
+    }
+
+private:
+    static constexpr size_t SHARDS = 64;
+    struct Shard {
+        mutex lock;
+        unordered_map<string_view, uint64_t> first;
+    };
+    Shard shards_[SHARDS];
+};
+
 // 记录每个输入节在最终内存中的映射信息
 struct SectionMapping {
     uint64_t vaddr;                 // 该节的虚拟地址
     const FLESection* original_section; // 指向原节
     const FLEObject* parent_obj;    // 所属目标文件
     string name;                    // 节名
+    size_t file_offset;             // 在输出缓冲区（.text | .plt | .rodata | .data）中的偏移，无文件内容时为 SIZE_MAX
 };
 
-FLEObject FLE_ld(const vector<FLEObject>& objects, const LinkerOptions& options)
+// 输入节：(目标文件, 节名)
+using SectionKey = pair<const FLEObject*, string>;
+// 本模块内符号的 GOT 槽：局部定义带上所在的目标文件，全局定义的目标文件记为 nullptr
+using LocalGotKey = pair<const FLEObject*, string>;
+// 参与布局的节，按最终的排列顺序
+using LayoutEntry = pair<const FLEObject*, const SectionHeader*>;
+
+// 符号的定义：所在的节与节内偏移
+struct SymbolDef { SectionKey sec; uint64_t offset; SymbolType type; bool ifunc; };
+// 符号的最终地址
+struct GlobalSym { SymbolType type; uint64_t addr; bool ifunc; };
+// 已放入某个段、等待段基址确定的输入节；seg_offset 是段内偏移
+struct PendingMap { const FLEObject* obj; const FLESection* sec; string name; size_t size; string cat; size_t seg_offset; };
+// 可合并的只读节（SHF_MERGE：字符串节，以及 .rodata.cst4/8/16 这类定长常量节）
+struct MergeInput { const FLEObject* obj; const SectionHeader* shdr; const FLESection* sec; };
+// 合并节中各项的起始偏移（in）及其在 rodata 中的位置（out）
+struct MergedPieces { vector<uint64_t> in; vector<uint64_t> out; };
+
+// 节名所属的输出段
+static string cat_of(const string& n)
+{
+    if (n.rfind(".text", 0) == 0) return "text";
+    if (n.rfind(".rodata", 0) == 0) return "rodata";
+    if (n.rfind(".data", 0) == 0) return "data";
+    if (n.rfind(".bss", 0) == 0) return "bss";
+    return "data";
+}
+
+static bool is_tls(const SectionHeader& shdr)
+{
+    return (shdr.flags & SHF::TLS) || shdr.name.rfind(".tdata", 0) == 0 || shdr.name.rfind(".tbss", 0) == 0;
+}
+
+static bool is_gotpcrel(RelocationType type)
+{
+    return type == RelocationType::R_X86_64_GOTPCREL || type == RelocationType::R_X86_64_GOTPCRELX;
+}
+
+// 合并节中偏移 off 处的 rodata 偏移；off 落在某一项内部时保持项内的相对位置
+static uint64_t merged_offset(const MergedPieces& mp, uint64_t off)
+{
+    size_t k = upper_bound(mp.in.begin(), mp.in.end(), off) - mp.in.begin();
+    if (k == 0) return mp.out.empty() ? 0 : mp.out[0];
+    return mp.out[k - 1] + (off - mp.in[k - 1]);
+}
+
+// 链接分为几个依次进行的阶段：输入扫描、符号解析、节筛选（--gc-sections、--icf）、
+// 合成节（PLT/GOT）定长、布局、重定位、输出。每个阶段是一个函数，只填写 LinkState 中
+// 属于自己的那部分，后一阶段只读取前面阶段的结果：PLT/GOT 的大小在布局之前就已确定，
+// 各段地址只计算一次
+struct LinkState {
+    explicit LinkState(const LinkerOptions& opts)
+        : options(opts)
+    {
+    }
+
+    const LinkerOptions& options;
+
+    // --stats：各阶段耗时
+    using Clock = chrono::steady_clock;
+    vector<pair<const char*, double>> phase_ms;
+    Clock::time_point link_begin = Clock::now(), phase_begin = link_begin;
+
+    // 0) 输入扫描
+    vector<const FLEObject*> active;      // 普通对象与选中的静态库成员
+    vector<const FLEObject*> shared_deps;
+
+    // 1) 符号解析：符号 -> 定义所在的节与节内偏移
+    map<string, SymbolDef> global_defs;
+    map<const FLEObject*, map<string, SymbolDef>> local_defs;
+    set<string> so_defined_globals;       // 共享库中定义的全局符号
+
+    // 节筛选
+    set<SectionKey> live_sections;        // --gc-sections 保留的节
+    map<SectionKey, SectionKey> folded;   // --icf：被折叠的节 -> 保留的节
+
+    // 2) 合成节
+    set<string> extern_funcs, extern_datas, tls_got; // tls_got：initial-exec 模型的 TLS 偏移槽
+    set<LocalGotKey> local_got;
+    map<string, size_t> got_index;        // 符号 -> 槽位
+    map<LocalGotKey, size_t> local_got_index;
+    size_t plt_size = 0, got_bytes = 0;
+
+    // 3) 布局
+    set<SectionKey> pc_relative_refs;     // 被以"节符号 + 加数"做 PC 相对引用的节
+    vector<LayoutEntry> layout_order;
+    vector<uint8_t> text_data, rodata_data, data_data;
+    uint64_t bss_size = 0;
+    uint64_t rodata_align = 1, bss_align = 1; // 各段内的最大对齐：紧凑布局下段基址不再是页边界，至少要按它对齐
+    vector<PendingMap> pending;
+    vector<MergeInput> merge_inputs;
+    map<SectionKey, MergedPieces> merged_pieces;
+    size_t tls_start = 0, tls_filesz = 0, tls_memsz = 0;
+    bool has_tls = false;
+    size_t original_data_size = 0;
+    bool code_with_rodata = false;
+    uint64_t text_base = 0, text_mem_size = 0, plt_base = 0, rodata_base = 0, data_base = 0, got_base = 0, bss_base = 0;
+    uint64_t tls_vaddr = 0, tls_tp = 0;
+    size_t rodata_file = 0, data_file = 0; // rodata、data 在输出缓冲区中的偏移
+    vector<SectionMapping> mappings;
+    map<SectionKey, uint64_t> section_addr;
+    map<string, GlobalSym> globals;       // 符号的最终地址（全局/弱 与 局部分离）
+    map<const FLEObject*, map<string, uint64_t>> locals;
+
+    // 4) 重定位
+    vector<uint8_t> output_data;          // .text | .plt | .rodata | .data | .got
+    vector<uint8_t> got_data;
+    vector<Relocation> dyn_relocs_out;
+
+    void end_phase(const char* name)
+    {
+        Clock::time_point now = Clock::now();
+        phase_ms.emplace_back(name, chrono::duration<double, milli>(now - phase_begin).count());
+        phase_begin = now;
+    }
+
+    // obj 中的重定位符号指向的定义（obj 为空时只查全局）；共享库提供或未定义时返回空。
+    // 只读，可以在多个线程中同时调用
+    const SymbolDef* resolve_def(const FLEObject* obj, const string& name) const
+    {
+        if (obj) {
+            auto lit = local_defs.find(obj);
+            if (lit != local_defs.end()) {
+                auto fit = lit->second.find(name);
+                if (fit != lit->second.end()) return &fit->second;
+            }
+        }
+        auto git = global_defs.find(name);
+        return git != global_defs.end() ? &git->second : nullptr;
+    }
+
+    bool is_live(const FLEObject* obj, const string& secname) const
+    {
+        return !options.gc_sections || live_sections.count({ obj, secname }) > 0;
+    }
+
+    // 本次链接定义的 IFUNC：调用与取址都必须经过 PLT/GOT，由加载器调用解析函数填槽
+    bool local_ifunc(const FLEObject* obj, const string& name) const
+    {
+        const SymbolDef* def = resolve_def(obj, name);
+        return def && def->ifunc && def->type != SymbolType::LOCAL;
+    }
+
+    LocalGotKey local_got_key(const FLEObject* obj, const string& name) const
+    {
+        const SymbolDef* def = resolve_def(obj, name);
+        return LocalGotKey{ def && def->type == SymbolType::LOCAL ? obj : nullptr, name };
+    }
+
+    // 可合并的节不逐字节拼接，去重后统一放在 rodata 中
+    bool is_mergeable(const FLEObject* objp, const SectionHeader& shdr, const FLESection& sec) const
+    {
+        if (!(shdr.flags & SHF::MERGE) || shdr.entsize == 0 || (shdr.flags & SHF::WRITE)) return false;
+        if (!sec.relocs.empty() || sec.data.size() != shdr.size) return false;
+        if (pc_relative_refs.count({ objp, shdr.name })) return false;
+        return (shdr.flags & SHF::STRINGS) || shdr.size % shdr.entsize == 0;
+    }
+
+    // 符号名所在的节：全局符号优先，否则取任一目标文件中的同名局部符号；被折叠的节换成保留的节
+    bool section_of_name(const string& name, SectionKey& key) const
+    {
+        const SymbolDef* def = resolve_def(nullptr, name);
+        for (auto* objp : active) {
+            if (def) break;
+            def = resolve_def(objp, name);
+        }
+        if (!def) return false;
+        key = def->sec;
+        auto fit = folded.find(key);
+        if (fit != folded.end()) key = fit->second;
+        return true;
+    }
+
+    // 按前缀把代码节分成 hot（.text.hot）、normal、startup（.text.startup、.text.exit）、
+    // unlikely（.text.unlikely）几组，数据节分成 relro（.data.rel.ro）与 normal，
+    // 返回所在分组在 --text-order/--data-order 中的位置
+    size_t group_of(const string& name) const
+    {
+        auto has_prefix = [&](const string& prefix) {
+            return name.compare(0, prefix.size(), prefix) == 0 && (name.size() == prefix.size() || name[prefix.size()] == '.');
+        };
+        string cat = cat_of(name), group = "normal";
+        const vector<string>* order = nullptr;
+        if (cat == "text") {
+            order = &options.text_order;
+            if (has_prefix(".text.hot")) group = "hot";
+            else if (has_prefix(".text.unlikely")) group = "unlikely";
+            else if (has_prefix(".text.startup") || has_prefix(".text.exit")) group = "startup";
+        } else if (cat == "data") {
+            order = &options.data_order;
+            if (has_prefix(".data.rel.ro")) group = "relro";
+        }
+        if (!order) return 0;
+        return find(order->begin(), order->end(), group) - order->begin();
+    }
+
+    // 符号的最终地址，所在节没有进入输出时为 0
+    uint64_t symbol_addr(const FLEObject* obj, const Symbol& sym) const
+    {
+        auto mit = merged_pieces.find({ obj, sym.section });
+        if (mit != merged_pieces.end()) return rodata_base + merged_offset(mit->second, sym.offset);
+        auto it = section_addr.find({ obj, sym.section });
+        return it == section_addr.end() ? 0 : it->second + sym.offset;
+    }
+
+    uint64_t lookup_addr(const FLEObject* obj, const string& name) const
+    {
+        auto lit = locals.find(obj);
+        if (lit != locals.end()) {
+            auto fit = lit->second.find(name);
+            if (fit != lit->second.end()) return fit->second;
+        }
+        auto git = globals.find(name);
+        if (git != globals.end()) return git->second.addr;
+        throw runtime_error("Undefined symbol: " + name);
+    }
+
+    bool is_internal(const FLEObject* obj, const string& name) const
+    {
+        auto lit = locals.find(obj);
+        if (lit != locals.end() && lit->second.count(name)) return true;
+        return globals.count(name) > 0;
+    }
+
+    bool is_ifunc(const FLEObject* obj, const string& name) const
+    {
+        auto lit = locals.find(obj);
+        if (lit != locals.end() && lit->second.count(name)) return false;
+        auto git = globals.find(name);
+        return git != globals.end() && git->second.ifunc;
+    }
+
+    // 段的起始地址
+    uint64_t segment_base(const string& cat) const
+    {
+        if (cat == "text") return text_base;
+        if (cat == "rodata") return rodata_base;
+        if (cat == "data") return data_base;
+        return bss_base;
+    }
+};
+
+// 0) 输入扫描：普通对象、静态库、共享库依赖；按未解析的引用选择静态库成员
+static void scan_inputs(LinkState& st, const vector<FLEObject>& objects)
 {
-    // 0) 解析输入：普通对象、静态库、共享库依赖
     vector<const FLEObject*> base_inputs;
     vector<const FLEObject*> archives;
-    vector<const FLEObject*> shared_deps;
     for (const auto& obj : objects) {
         if (obj.type == ".ar") archives.push_back(&obj);
-        else if (obj.type == ".so") shared_deps.push_back(&obj);
+        else if (obj.type == ".so") st.shared_deps.push_back(&obj);
         else base_inputs.push_back(&obj);
     }
 
@@ -66,12 +440,12 @@ FLEObject FLE_ld(const vector<FLEObject>& objects, const LinkerOptions& options)
     };
     for (auto* o : base_inputs) seed_sections(o, 0);
 
-    vector<const FLEObject*> active = base_inputs;
+    st.active = base_inputs;
     set<const FLEObject*> included_members;
     bool changed = true;
     while (changed) {
         changed = false;
-        auto unresolved = collect_unresolved(active, globals_seed, locals_seed);
+        auto unresolved = collect_unresolved(st.active, globals_seed, locals_seed);
         if (unresolved.empty()) break;
         for (auto* ar : archives) {
             for (const auto& mem : ar->members) {
@@ -84,7 +458,7 @@ FLEObject FLE_ld(const vector<FLEObject>& objects, const LinkerOptions& options)
                 }
                 if (useful) {
                     // 选择该成员
-                    active.push_back(&mem);
+                    st.active.push_back(&mem);
                     included_members.insert(&mem);
                     seed_sections(&mem, 0);
                     changed = true;
@@ -92,155 +466,625 @@ FLEObject FLE_ld(const vector<FLEObject>& objects, const LinkerOptions& options)
             }
         }
     }
+}
 
-    // 1) 分类并合并节到多段：text/rodata/data/bss
-    vector<uint8_t> text_data, rodata_data, data_data;
-    uint64_t bss_size = 0;
-    struct PendingMap { const FLEObject* obj; const FLESection* sec; string name; size_t size; string cat; size_t seg_offset; };
-    vector<PendingMap> pending;
-    auto cat_of = [](const string& n) {
-        if (n.rfind(".text", 0) == 0) return string("text");
-        if (n.rfind(".rodata", 0) == 0) return string("rodata");
-        if (n.rfind(".data", 0) == 0) return string("data");
-        if (n.rfind(".bss", 0) == 0) return string("bss");
-        return string("data");
-    };
+// 1) 符号解析：每个名字确定唯一的定义（所在的节与节内偏移），之后的阶段都通过 resolve_def 查询。
+// 全局定义强符号优先，否则取第一个定义；两个强定义报错
+static void resolve_symbols(LinkState& st)
+{
+    for (auto* objp : st.active) {
+        for (const auto& sym : objp->symbols) {
+            if (sym.section.empty()) continue;
+            SymbolDef def{ { objp, sym.section }, sym.offset, sym.type, sym.ifunc };
+            if (sym.type == SymbolType::LOCAL) { st.local_defs[objp].emplace(sym.name, def); continue; }
+            auto it = st.global_defs.find(sym.name);
+            if (it == st.global_defs.end()) st.global_defs.emplace(sym.name, def);
+            else if (it->second.type == SymbolType::GLOBAL && sym.type == SymbolType::GLOBAL)
+                throw runtime_error("Multiple definition of strong symbol: " + sym.name);
+            else if (it->second.type == SymbolType::WEAK && sym.type == SymbolType::GLOBAL) it->second = def;
+        }
+        // 节名伪符号，优先级低于同名的局部符号
+        for (const auto& [secname, sec] : objp->sections) st.local_defs[objp].emplace(secname, SymbolDef{ { objp, secname }, 0, SymbolType::LOCAL, false });
+    }
 
-    for (auto* objp : active) {
-        const auto& obj = *objp;
-        for (const auto& shdr : obj.shdrs) {
-            auto it = obj.sections.find(shdr.name);
-            if (it == obj.sections.end()) continue;
-            const FLESection& section = it->second;
-            string cat = cat_of(shdr.name);
-            size_t seg_off = 0;
-            if (cat == "text") { seg_off = text_data.size(); text_data.insert(text_data.end(), section.data.begin(), section.data.end()); }
-            else if (cat == "rodata") { seg_off = rodata_data.size(); rodata_data.insert(rodata_data.end(), section.data.begin(), section.data.end()); }
-            else if (cat == "data") { seg_off = data_data.size(); data_data.insert(data_data.end(), section.data.begin(), section.data.end()); }
-            else { seg_off = bss_size; bss_size += shdr.size; }
-            pending.push_back({ objp, &section, shdr.name, (size_t)shdr.size, cat, seg_off });
-        }
-    }
-
-    // 收集共享库中已定义的全局符号名（用于强制走 PLT）
-    set<string> so_defined_globals;
-    for (auto* so : shared_deps) {
+    // 共享库中定义的全局符号：本模块没有定义时由它们提供
+    for (auto* so : st.shared_deps) {
         for (const auto& sym : so->symbols) {
             if (!sym.section.empty() && (sym.type == SymbolType::GLOBAL || sym.type == SymbolType::WEAK)) {
-                so_defined_globals.insert(sym.name);
+                st.so_defined_globals.insert(sym.name);
+            }
+        }
+    }
+}
+
+// --gc-sections：从入口符号（共享库为全部导出符号）以及共享库引用的符号出发，
+// 沿重定位标记可达的节；不可达的节不参与布局，其中定义的符号也随之丢弃
+static void gc_sections(LinkState& st)
+{
+    const LinkerOptions& options = st.options;
+    vector<SectionKey> worklist;
+    auto mark = [&](const SectionKey& key) {
+        if (key.first->sections.count(key.second) && st.live_sections.insert(key).second) worklist.push_back(key);
+    };
+    auto mark_symbol = [&](const FLEObject* obj, const string& name) {
+        if (const SymbolDef* def = st.resolve_def(obj, name)) mark(def->sec);
+    };
+
+    if (options.shared) {
+        for (const auto& [name, def] : st.global_defs) mark(def.sec);
+    } else {
+        mark_symbol(nullptr, options.entryPoint.empty() ? string("_start") : options.entryPoint);
+    }
+    for (auto* so : st.shared_deps) {
+        for (const auto& r : so->dyn_relocs) mark_symbol(nullptr, r.symbol);
+    }
+    while (!worklist.empty()) {
+        SectionKey key = worklist.back();
+        worklist.pop_back();
+        for (const auto& r : key.first->sections.at(key.second).relocs) mark_symbol(key.first, r.symbol);
+    }
+
+    if (options.print_gc_sections) {
+        for (auto* objp : st.active) {
+            for (const auto& shdr : objp->shdrs) {
+                if (objp->sections.count(shdr.name) && !st.is_live(objp, shdr.name))
+                    cerr << "removing unused section " << objp->name << ":(" << shdr.name << ")" << endl;
+            }
+        }
+    }
+}
+
+// --icf：折叠字节内容与重定位都相同的代码节，被折叠节上的符号指向保留的那一份。
+// 先按内容与非代码节的重定位目标分组，再反复用各节重定位目标所在的组细分，直到不再变化。
+// safe 模式只折叠地址没有被使用的节（仅被直接调用/跳转引用，且不对共享库可见）
+static void fold_identical_sections(LinkState& st)
+{
+    const LinkerOptions& options = st.options;
+    vector<SectionKey> cands;
+    for (auto* objp : st.active) {
+        for (const auto& shdr : objp->shdrs) {
+            if (shdr.name.rfind(".text", 0) != 0 || shdr.size == 0 || (shdr.flags & SHF::TLS)) continue;
+            if (objp->sections.count(shdr.name) && st.is_live(objp, shdr.name)) cands.push_back({ objp, shdr.name });
+        }
+    }
+    if (options.icf == "safe") {
+        set<SectionKey> significant;
+        for (auto* objp : st.active) {
+            for (const auto& [secname, sec] : objp->sections) {
+                if (!st.is_live(objp, secname)) continue;
+                for (const auto& r : sec.relocs) {
+                    const SymbolDef* def = st.resolve_def(objp, r.symbol);
+                    if (def && !is_direct_branch(sec, r)) significant.insert(def->sec);
+                }
+            }
+        }
+        for (auto* so : st.shared_deps) {
+            for (const auto& r : so->dyn_relocs) {
+                if (const SymbolDef* def = st.resolve_def(nullptr, r.symbol)) significant.insert(def->sec);
+            }
+        }
+        if (options.shared) {
+            for (const auto& [name, def] : st.global_defs) significant.insert(def.sec);
+        }
+        cands.erase(remove_if(cands.begin(), cands.end(), [&](const SectionKey& k) { return significant.count(k) > 0; }), cands.end());
+    }
+
+    map<SectionKey, size_t> cand_index;
+    for (size_t i = 0; i < cands.size(); ++i) cand_index.emplace(cands[i], i);
+
+    // 每个候选节的"形状"：字节、重定位及非候选目标；指向候选节的重定位记入 edges，在迭代中比较
+    size_t n = cands.size();
+    vector<string> shapes(n);
+    vector<uint64_t> hashes(n);
+    vector<vector<size_t>> edges(n);
+    parallel_for(n, [&](size_t i) {
+        const FLEObject* obj = cands[i].first;
+        const FLESection& sec = obj->sections.at(cands[i].second);
+        string& shape = shapes[i];
+        shape.assign(sec.data.begin(), sec.data.end());
+        for (const auto& r : sec.relocs) {
+            shape += "|" + to_string(r.offset) + "," + to_string(static_cast<int>(r.type)) + "," + to_string(r.addend) + ":";
+            const SymbolDef* def = st.resolve_def(obj, r.symbol);
+            if (!def) {
+                shape += "@" + r.symbol;
+                continue;
+            }
+            auto cit = cand_index.find(def->sec);
+            if (cit != cand_index.end()) {
+                shape += "c" + to_string(def->offset);
+                edges[i].push_back(cit->second);
+            } else {
+                shape += to_string(reinterpret_cast<uintptr_t>(def->sec.first)) + def->sec.second + "+" + to_string(def->offset);
+            }
+        }
+        hashes[i] = hash_bytes(shape);
+    });
+
+    vector<size_t> cls(n);
+    {
+        unordered_map<uint64_t, vector<size_t>> buckets; // 哈希 -> 已有的组代表
+        size_t next = 0;
+        for (size_t i = 0; i < n; ++i) {
+            auto& reps = buckets[hashes[i]];
+            auto it = find_if(reps.begin(), reps.end(), [&](size_t r) { return shapes[r] == shapes[i]; });
+            if (it == reps.end()) { reps.push_back(i); cls[i] = next++; }
+            else cls[i] = cls[*it];
+        }
+        size_t classes = next;
+        while (true) {
+            map<pair<size_t, vector<size_t>>, size_t> refined;
+            vector<size_t> next_cls(n);
+            for (size_t i = 0; i < n; ++i) {
+                vector<size_t> targets;
+                for (size_t t : edges[i]) targets.push_back(cls[t]);
+                next_cls[i] = refined.emplace(make_pair(cls[i], move(targets)), refined.size()).first->second;
             }
+            cls.swap(next_cls);
+            if (refined.size() == classes) break;
+            classes = refined.size();
         }
     }
 
-    // 预扫描：外部引用（用于 EXE 的 PLT/GOT）——按重定位类型收集
-    set<string> extern_funcs, extern_datas;
-    if (!options.shared) {
-        for (const auto& pm : pending) {
-            for (const auto& r : pm.sec->relocs) {
+    map<size_t, size_t> keeper; // 组 -> 保留的节（输入顺序中的第一个）
+    for (size_t i = 0; i < n; ++i) {
+        auto [it, first] = keeper.emplace(cls[i], i);
+        if (first) continue;
+        st.folded.emplace(cands[i], cands[it->second]);
+        if (options.print_icf_sections)
+            cerr << "folding identical section " << cands[i].first->name << ":(" << cands[i].second << ") into "
+                 << cands[it->second].first->name << ":(" << cands[it->second].second << ")" << endl;
+    }
+}
+
+// 2) 合成节定长：在布局之前根据符号解析的结果确定 PLT 桩与 GOT 槽。
+// 只有共享库提供的符号（以及 IFUNC）才有 PLT 桩、GOT 槽和动态重定位；本模块内定义的符号直接引用，
+// GOTPCRELX 在松弛后同样直接引用；普通 GOTPCREL 和无法改写的指令使用链接时填好地址的 GOT 槽
+// （local_got，不需要动态重定位）。局部符号的槽按 (目标文件, 符号) 区分，与外部符号的槽分开编号。
+// 既不在本模块也不在共享库中定义的符号在这里就报错
+static void size_synthetic_sections(LinkState& st)
+{
+    if (st.options.shared) return;
+    for (auto* objp : st.active) {
+        for (const auto& shdr : objp->shdrs) {
+            auto it = objp->sections.find(shdr.name);
+            if (it == objp->sections.end() || !st.is_live(objp, shdr.name) || st.folded.count({ objp, shdr.name })) continue;
+            bool code = cat_of(shdr.name) == "text" && !is_tls(shdr);
+            for (const auto& r : it->second.relocs) {
                 if (r.symbol.size() && r.symbol[0] == '.') continue; // 跳过节名等伪符号
-                if (r.type == RelocationType::R_X86_64_PC32) {
-                    extern_funcs.insert(r.symbol);
-                    if (so_defined_globals.count(r.symbol)) extern_funcs.insert(r.symbol);
-                } else if (r.type == RelocationType::R_X86_64_GOTPCREL) {
-                    extern_datas.insert(r.symbol);
+                bool here = st.resolve_def(objp, r.symbol) != nullptr;
+                if (!here && !st.so_defined_globals.count(r.symbol)) throw runtime_error("Undefined symbol: " + r.symbol);
+                if (st.local_ifunc(objp, r.symbol) && !is_gotpcrel(r.type)) {
+                    st.extern_funcs.insert(r.symbol); // 绝对地址引用也指向 PLT 桩
+                } else if (r.type == RelocationType::R_X86_64_PC32) {
+                    if (!here) st.extern_funcs.insert(r.symbol);
+                } else if (is_gotpcrel(r.type)) {
+                    bool relaxable = r.type == RelocationType::R_X86_64_GOTPCRELX && code
+                        && is_relaxable_gotpcrel(it->second.data, r.offset, r.addend);
+                    if (!here || st.local_ifunc(objp, r.symbol)) st.extern_datas.insert(r.symbol);
+                    else if (!relaxable) st.local_got.insert(st.local_got_key(objp, r.symbol));
+                } else if (r.type == RelocationType::R_X86_64_GOTTPOFF) {
+                    st.tls_got.insert(r.symbol);
                 }
             }
         }
     }
 
-    size_t plt_size = options.shared ? 0 : extern_funcs.size() * 6;
+    st.plt_size = st.extern_funcs.size() * 6;
+
+    // GOT 槽位：先是 PLT 对应的槽，再是数据、TLS 偏移的槽，最后是本模块符号的槽
+    size_t idx = 0;
+    for (const auto& s : st.extern_funcs) st.got_index.emplace(s, idx++);
+    for (const auto& s : st.extern_datas) if (!st.got_index.count(s)) st.got_index.emplace(s, idx++);
+    for (const auto& s : st.tls_got) if (!st.got_index.count(s)) st.got_index.emplace(s, idx++);
+    for (const auto& key : st.local_got) st.local_got_index.emplace(key, idx++);
+    st.got_bytes = (st.got_index.size() + st.local_got_index.size()) * 8;
+}
 
-    // 预构建 GOT 索引，后续用于确定各段基址
-    map<string, size_t> got_index; // 符号 -> 槽位
-    if (!options.shared) {
-        size_t idx = 0;
-        for (const auto& s : extern_funcs) got_index.emplace(s, idx++);
-        for (const auto& s : extern_datas) if (!got_index.count(s)) got_index.emplace(s, idx++);
+// --call-graph-sort：按调用图用 C3 启发式排列代码节。边权默认是两节之间 PC32 重定位的个数，
+// 给出 --call-graph-profile 时改用折叠栈中相邻两帧的采样数；节的权重是入边权重之和。
+// 按密度（权重 / 大小）从高到低处理各节，把它所在的簇接到最重调用者所在簇的末尾，
+// 前提是这条边占该节权重的一成以上、合并后不超过 1 MiB 且密度不低于调用者簇的 1/8。
+// 最后各簇按密度排列，接在 text_rank 中已有的节之后。返回 (调用图中的节数, 簇数)
+static pair<size_t, size_t> sort_call_graph(const LinkState& st, const map<SectionKey, uint64_t>& text_sizes,
+    map<SectionKey, size_t>& text_rank, set<SectionKey>& graph_sections)
+{
+    constexpr uint64_t MAX_CLUSTER_SIZE = 1 << 20;
+    constexpr double MAX_DENSITY_DEGRADATION = 8;
+    vector<SectionKey> nodes;
+    map<SectionKey, size_t> node_index;
+    for (const auto& [objp, shdrp] : st.layout_order) {
+        SectionKey key{ objp, shdrp->name };
+        if (text_sizes.count(key)) { node_index.emplace(key, nodes.size()); nodes.push_back(key); }
+    }
+    map<pair<size_t, size_t>, uint64_t> edges;
+    auto add_edge = [&](const SectionKey& from, const SectionKey& to, uint64_t weight) {
+        auto fit = node_index.find(from), tit = node_index.find(to);
+        if (fit != node_index.end() && tit != node_index.end() && fit->second != tit->second)
+            edges[{ fit->second, tit->second }] += weight;
+    };
+    if (st.options.call_graph_profile.empty()) {
+        for (const auto& key : nodes) {
+            for (const auto& r : key.first->sections.at(key.second).relocs) {
+                if (r.type != RelocationType::R_X86_64_PC32) continue;
+                if (const SymbolDef* def = st.resolve_def(key.first, r.symbol)) {
+                    auto fit = st.folded.find(def->sec);
+                    add_edge(key, fit != st.folded.end() ? fit->second : def->sec, 1);
+                }
+            }
+        }
+    } else {
+        for (const auto& [call, count] : st.options.call_graph_profile) {
+            SectionKey from, to;
+            if (st.section_of_name(call.first, from) && st.section_of_name(call.second, to)) add_edge(from, to, count);
+        }
     }
-    size_t original_data_size = data_data.size();
-    size_t got_bytes = options.shared ? 0 : got_index.size() * 8;
 
-    // 段地址与权限（考虑 .plt 紧随 .text，.got 独立对齐，最终 bss 基址基于最终布局）
-    uint64_t text_base = BASE_ADDR;
-    uint64_t rodata_base = align_up(text_base + text_data.size() + plt_size, 4096);
-    uint64_t data_base = align_up(rodata_base + rodata_data.size(), 4096);
-    uint64_t got_base = align_up(data_base + original_data_size, 4096);
-    uint64_t bss_base = align_up(got_base + got_bytes, 4096);
+    struct Cluster { vector<size_t> secs; uint64_t size; uint64_t weight = 0; uint64_t initial_weight = 0; size_t best_pred = SIZE_MAX; uint64_t best_weight = 0; };
+    size_t n = nodes.size();
+    vector<Cluster> clusters(n);
+    vector<bool> in_graph(n, false);
+    for (size_t i = 0; i < n; ++i) clusters[i].secs = { i }, clusters[i].size = max<uint64_t>(text_sizes.at(nodes[i]), 1);
+    for (const auto& [edge, weight] : edges) {
+        auto [from, to] = edge;
+        in_graph[from] = in_graph[to] = true;
+        clusters[to].weight += weight;
+        if (weight > clusters[to].best_weight) { clusters[to].best_weight = weight; clusters[to].best_pred = from; }
+    }
+    for (auto& c : clusters) c.initial_weight = c.weight;
+    auto density = [](const Cluster& c) { return static_cast<double>(c.weight) / c.size; };
 
-    // 构造映射（节 -> 虚拟地址），使用最终计算的 bss 基址
-    vector<SectionMapping> mappings;
-    for (const auto& pm : pending) {
-        uint64_t base = 0;
-        if (pm.cat == "text") base = text_base;
-        else if (pm.cat == "rodata") base = rodata_base;
-        else if (pm.cat == "data") base = data_base;
-        else base = bss_base;
-        mappings.push_back({ base + pm.seg_offset, pm.sec, pm.obj, pm.name });
+    vector<size_t> leader(n);
+    for (size_t i = 0; i < n; ++i) leader[i] = i;
+    function<size_t(size_t)> find_leader = [&](size_t i) { return leader[i] == i ? i : leader[i] = find_leader(leader[i]); };
+
+    vector<size_t> sorted;
+    for (size_t i = 0; i < n; ++i) if (in_graph[i]) sorted.push_back(i);
+    stable_sort(sorted.begin(), sorted.end(), [&](size_t a, size_t b) { return density(clusters[a]) > density(clusters[b]); });
+    for (size_t i : sorted) {
+        Cluster& c = clusters[i];
+        if (c.best_pred == SIZE_MAX || c.best_weight * 10 <= c.initial_weight) continue;
+        size_t pred = find_leader(c.best_pred);
+        if (pred == i) continue;
+        Cluster& pc = clusters[pred];
+        if (c.size + pc.size > MAX_CLUSTER_SIZE) continue;
+        double merged = static_cast<double>(c.weight + pc.weight) / (c.size + pc.size);
+        if (merged < density(pc) / MAX_DENSITY_DEGRADATION) continue;
+        leader[i] = pred;
+        pc.secs.insert(pc.secs.end(), c.secs.begin(), c.secs.end());
+        pc.size += c.size;
+        pc.weight += c.weight;
+        c.secs.clear();
     }
 
-    // 2) 解析符号 -> 绝对地址（全局/弱 与 局部分离）
-    struct GlobalSym { SymbolType type; uint64_t addr; };
-    map<string, GlobalSym> globals;
-    map<const FLEObject*, map<string, uint64_t>> locals;
+    vector<size_t> order;
+    for (size_t i : sorted) if (!clusters[i].secs.empty()) order.push_back(i);
+    stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return density(clusters[a]) > density(clusters[b]); });
+    for (size_t i : order) {
+        for (size_t sec : clusters[i].secs) text_rank.emplace(nodes[sec], text_rank.size());
+    }
+    for (size_t i : sorted) graph_sections.insert(nodes[i]);
+    return { sorted.size(), order.size() };
+}
 
-    auto find_base = [&](const FLEObject* obj, const string& secname) -> uint64_t {
-        for (const auto& mp : mappings) {
-            if (mp.parent_obj == obj && mp.name == secname) return mp.vaddr;
+// 3) 布局的第一步：确定各输入节的排列顺序（layout_order）。
+// 代码节与数据节按所在分组（group_of）连续排列；组内 --symbol-ordering-file 列出的符号所在的
+// 代码节按文件中的顺序排在最前面，接着是 --call-graph-sort 的结果，其余保持输入顺序
+static void order_sections(LinkState& st)
+{
+    const LinkerOptions& options = st.options;
+
+    // 以"节符号 + 加数"做 PC 相对引用时，加数里还含有指令偏置（-4，后跟立即数时是 -5、-8），
+    // 只看加数无法知道指向节内哪一项。汇编器对合并节中的标号保留符号引用，只有手写的
+    // 节符号引用会落到这里：这样的节不参与合并，按普通只读数据原样布局
+    for (auto* objp : st.active) {
+        for (const auto& [name, sec] : objp->sections) {
+            for (const auto& reloc : sec.relocs) {
+                bool absolute = reloc.type == RelocationType::R_X86_64_64 || reloc.type == RelocationType::R_X86_64_32
+                    || reloc.type == RelocationType::R_X86_64_32S;
+                if (!absolute && objp->sections.count(reloc.symbol)) st.pc_relative_refs.insert({ objp, reloc.symbol });
+            }
+        }
+    }
+
+    map<SectionKey, uint64_t> text_sizes; // 进入代码段、可以调整顺序的节
+    for (auto* objp : st.active) {
+        for (const auto& shdr : objp->shdrs) {
+            st.layout_order.push_back({ objp, &shdr });
+            auto it = objp->sections.find(shdr.name);
+            if (it == objp->sections.end() || cat_of(shdr.name) != "text" || is_tls(shdr)) continue;
+            if (!st.is_live(objp, shdr.name) || st.folded.count({ objp, shdr.name }) || st.is_mergeable(objp, shdr, it->second)) continue;
+            text_sizes.emplace(SectionKey{ objp, shdr.name }, shdr.size);
+        }
+    }
+
+    map<SectionKey, size_t> text_rank;
+    for (const auto& name : options.symbol_ordering) {
+        SectionKey key;
+        if (!st.section_of_name(name, key)) {
+            bool in_shared = any_of(st.shared_deps.begin(), st.shared_deps.end(), [&](const FLEObject* so) {
+                return any_of(so->symbols.begin(), so->symbols.end(), [&](const Symbol& sym) { return sym.name == name && !sym.section.empty(); });
+            });
+            if (!in_shared) cerr << "warning: symbol ordering file: no such symbol: " << name << endl;
+            continue;
+        }
+        if (text_sizes.count(key)) text_rank.emplace(key, text_rank.size());
+    }
+
+    size_t graph_nodes = 0, graph_clusters = 0;
+    set<SectionKey> graph_sections;
+    if (options.call_graph_sort) {
+        tie(graph_nodes, graph_clusters) = sort_call_graph(st, text_sizes, text_rank, graph_sections);
+    }
+
+    // 调用图中的节在代码段里覆盖的页数，用于估计重排前后的效果
+    auto graph_pages = [&]() {
+        set<uint64_t> pages;
+        uint64_t off = 0;
+        for (const auto& [objp, shdrp] : st.layout_order) {
+            auto it = text_sizes.find({ objp, shdrp->name });
+            if (it == text_sizes.end()) continue;
+            if (graph_sections.count(it->first) && it->second > 0) {
+                for (uint64_t p = off / 4096; p <= (off + it->second - 1) / 4096; ++p) pages.insert(p);
+            }
+            off += it->second;
         }
-        return 0;
+        return pages.size();
     };
+    size_t pages_before = graph_pages();
+    auto rank = [&](const LayoutEntry& s) {
+        auto it = text_rank.find({ s.first, s.second->name });
+        return make_pair(st.group_of(s.second->name), it != text_rank.end() ? it->second : SIZE_MAX);
+    };
+    stable_sort(st.layout_order.begin(), st.layout_order.end(), [&](const auto& a, const auto& b) { return rank(a) < rank(b); });
+    if (options.call_graph_sort) {
+        cerr << "call graph sort: " << graph_nodes << " sections in " << graph_clusters << " clusters, estimated pages touched: "
+             << pages_before << " -> " << graph_pages() << endl;
+    }
+}
 
-    for (auto* objp : active) {
+// 按 layout_order 把节拼接到 text/rodata/data/bss 各段；可合并的节留给 merge_constants
+static void place_sections(LinkState& st)
+{
+    constexpr uint64_t TEXT_GROUP_ALIGN = 64;
+    size_t text_group = SIZE_MAX;
+    for (const auto& [objp, shdrp] : st.layout_order) {
         const auto& obj = *objp;
-        for (const auto& sym : obj.symbols) {
+        const auto& shdr = *shdrp;
+        auto it = obj.sections.find(shdr.name);
+        if (it == obj.sections.end()) continue;
+        if (is_tls(shdr) || !st.is_live(objp, shdr.name) || st.folded.count({ objp, shdr.name })) continue;
+        const FLESection& section = it->second;
+        if (st.is_mergeable(objp, shdr, section)) { st.merge_inputs.push_back({ objp, &shdr, &section }); continue; }
+        string cat = cat_of(shdr.name);
+        size_t seg_off = 0;
+        if (cat == "text" && st.group_of(shdr.name) != text_group) {
+            // 新的一组从新的缓存行开始，冷热代码不共用缓存行
+            if (!st.text_data.empty()) pad_with_nops(st.text_data, align_up(st.text_data.size(), TEXT_GROUP_ALIGN));
+            text_group = st.group_of(shdr.name);
+        }
+        // 每个节按自身的 addralign 对齐：代码用 NOP 填充，数据用 0 填充
+        uint64_t align = max<uint64_t>(shdr.addralign, 1);
+        if (cat == "text") {
+            pad_with_nops(st.text_data, align_up(st.text_data.size(), align));
+            seg_off = st.text_data.size();
+            st.text_data.insert(st.text_data.end(), section.data.begin(), section.data.end());
+        } else if (cat == "rodata") {
+            st.rodata_align = max(st.rodata_align, align);
+            st.rodata_data.resize(align_up(st.rodata_data.size(), align), 0);
+            seg_off = st.rodata_data.size();
+            st.rodata_data.insert(st.rodata_data.end(), section.data.begin(), section.data.end());
+        } else if (cat == "data") {
+            st.data_data.resize(align_up(st.data_data.size(), align), 0);
+            seg_off = st.data_data.size();
+            st.data_data.insert(st.data_data.end(), section.data.begin(), section.data.end());
+        } else {
+            st.bss_align = max(st.bss_align, align);
+            st.bss_size = align_up(st.bss_size, align);
+            seg_off = st.bss_size;
+            st.bss_size += shdr.size;
+        }
+        st.pending.push_back({ objp, &section, shdr.name, (size_t)shdr.size, cat, seg_off });
+    }
+}
+
+// 合并常量：字符串节切成以 entsize 个零字节结尾的字符串，定长常量节切成 entsize 字节的项，
+// 放入并发哈希集合去重。字符串再按反转后的内容排序，是另一字符串后缀的字符串（尾部合并）
+// 直接指向那个字符串的末尾。每组（字符串或常量、entsize、对齐）按最早出现的顺序排在 rodata 末尾，
+// 起点按 entsize 对齐；节的 addralign 大于 entsize 时每一项都按它对齐，这样的字符串不做尾部合并。
+// merged_pieces 记录每个输入节中各项的起始偏移及其在 rodata 中的位置
+static void merge_constants(LinkState& st)
+{
+    if (st.merge_inputs.empty()) return;
+    size_t n = st.merge_inputs.size();
+    vector<vector<string_view>> pieces(n);
+    using PoolKey = tuple<bool, uint64_t, uint64_t>; // (是否字符串, entsize, 每项的对齐)
+    auto pool_key = [](const MergeInput& mi) {
+        return PoolKey{ (mi.shdr->flags & SHF::STRINGS) != 0, mi.shdr->entsize, max(mi.shdr->entsize, mi.shdr->addralign) };
+    };
+    map<PoolKey, ConcurrentStringSet> pools;
+    for (const auto& mi : st.merge_inputs) pools[pool_key(mi)];
+    parallel_for(n, [&](size_t i) {
+        const auto& mi = st.merge_inputs[i];
+        uint64_t es = mi.shdr->entsize;
+        const char* data = reinterpret_cast<const char*>(mi.sec->data.data());
+        size_t size = mi.sec->data.size();
+        if (mi.shdr->flags & SHF::STRINGS) {
+            size_t start = 0;
+            for (size_t off = 0; off + es <= size; off += es) {
+                bool terminator = all_of(data + off, data + off + es, [](char c) { return c == 0; });
+                if (!terminator) continue;
+                pieces[i].emplace_back(data + start, off + es - start);
+                start = off + es;
+            }
+            if (start < size) pieces[i].emplace_back(data + start, size - start); // 没有结束符的尾部
+        } else {
+            for (size_t off = 0; off < size; off += es) pieces[i].emplace_back(data + off, es);
+        }
+        ConcurrentStringSet& pool = pools.at(pool_key(mi));
+        for (size_t k = 0; k < pieces[i].size(); ++k) pool.insert(pieces[i][k], (static_cast<uint64_t>(i) << 32) | k);
+    });
+
+    map<PoolKey, unordered_map<string_view, uint64_t>> placed; // 组 -> 内容 -> rodata 偏移
+    for (const auto& [key, pool] : pools) {
+        auto [is_strings, es, align] = key;
+        vector<string_view> strings = pool.ordered();
+        vector<size_t> by_tail(is_strings && align == es ? strings.size() : 0);
+        for (size_t i = 0; i < by_tail.size(); ++i) by_tail[i] = i;
+        sort(by_tail.begin(), by_tail.end(), [&](size_t a, size_t b) {
+            return lexicographical_compare(strings[a].rbegin(), strings[a].rend(), strings[b].rbegin(), strings[b].rend());
+        });
+        // host[i]：容纳字符串 i 的字符串（自身或以它为后缀的更长字符串）；定长常量不做尾部合并
+        vector<size_t> host(strings.size());
+        for (size_t i = 0; i < host.size(); ++i) host[i] = i;
+        size_t last = SIZE_MAX;
+        for (size_t k = by_tail.size(); k-- > 0;) {
+            size_t i = by_tail[k];
+            const string_view& str = strings[i];
+            if (last != SIZE_MAX && strings[last].size() >= str.size()
+                && strings[last].compare(strings[last].size() - str.size(), str.size(), str) == 0) {
+                host[i] = last;
+            } else {
+                host[i] = last = i;
+            }
+        }
+        auto& offsets = placed[key];
+        st.rodata_align = max(st.rodata_align, align);
+        for (size_t i = 0; i < strings.size(); ++i) {
+            if (host[i] != i) continue;
+            st.rodata_data.resize(align_up(st.rodata_data.size(), align), 0);
+            offsets[strings[i]] = st.rodata_data.size();
+            st.rodata_data.insert(st.rodata_data.end(), strings[i].begin(), strings[i].end());
+        }
+        for (size_t i = 0; i < strings.size(); ++i) {
+            if (host[i] != i) offsets[strings[i]] = offsets.at(strings[host[i]]) + strings[host[i]].size() - strings[i].size();
+        }
+    }
+
+    for (size_t i = 0; i < n; ++i) {
+        const auto& mi = st.merge_inputs[i];
+        const auto& offsets = placed.at(pool_key(mi));
+        MergedPieces& mp = st.merged_pieces[{ mi.obj, mi.shdr->name }];
+        const char* data = reinterpret_cast<const char*>(mi.sec->data.data());
+        for (const auto& piece : pieces[i]) {
+            mp.in.push_back(static_cast<uint64_t>(piece.data() - data));
+            mp.out.push_back(offsets.at(piece));
+        }
+    }
+}
+
+// 线程局部存储：.tdata 作为 TLS 模板放在只读数据末尾，.tbss 只占 TLS 块空间。
+// seg_offset 对 tdata 是 rodata 内偏移，对 tbss 是 TLS 块内偏移
+static void place_tls(LinkState& st)
+{
+    for (int pass = 0; pass < 2; ++pass) {
+        for (auto* objp : st.active) {
+            for (const auto& shdr : objp->shdrs) {
+                auto it = objp->sections.find(shdr.name);
+                if (it == objp->sections.end() || !is_tls(shdr) || !st.is_live(objp, shdr.name)) continue;
+                if (st.options.shared)
+                    throw runtime_error("Thread-local storage is only supported in executables: " + shdr.name + " in " + objp->name);
+                bool nobits = (shdr.flags & SHF::NOBITS) || shdr.name.rfind(".tbss", 0) == 0;
+                if (nobits != (pass == 1)) continue;
+                if (!st.has_tls) {
+                    st.rodata_align = max(st.rodata_align, FLE_TLS_ALIGN);
+                    st.rodata_data.resize(align_up(st.rodata_data.size(), FLE_TLS_ALIGN), 0);
+                    st.tls_start = st.rodata_data.size();
+                    st.has_tls = true;
+                }
+                // TLS 块本身只按 FLE_TLS_ALIGN 对齐，块内的对齐不能超过它
+                uint64_t align = min<uint64_t>(max<uint64_t>(shdr.addralign, 1), FLE_TLS_ALIGN);
+                if (!nobits) {
+                    st.rodata_data.resize(st.tls_start + align_up(st.rodata_data.size() - st.tls_start, align), 0);
+                    st.pending.push_back({ objp, &it->second, shdr.name, (size_t)shdr.size, "tdata", st.rodata_data.size() });
+                    st.rodata_data.insert(st.rodata_data.end(), it->second.data.begin(), it->second.data.end());
+                    st.tls_filesz = st.tls_memsz = st.rodata_data.size() - st.tls_start;
+                } else {
+                    st.tls_memsz = align_up(st.tls_memsz, align);
+                    st.pending.push_back({ objp, &it->second, shdr.name, (size_t)shdr.size, "tbss", st.tls_memsz });
+                    st.tls_memsz += shdr.size;
+                }
+            }
+        }
+    }
+}
+
+// 段地址与权限（考虑 .plt 紧随 .text，.got 独立对齐，最终 bss 基址基于最终布局），
+// 随后确定每个节和符号的最终地址
+static void assign_addresses(LinkState& st)
+{
+    const LinkerOptions& options = st.options;
+    st.original_data_size = st.data_data.size();
+
+    // --huge-text：代码段占满整数个 2 MiB 大页，后续段从下一个大页边界开始
+    // -z noseparate-code：.rodata 紧跟代码，两者共用的页可读可执行
+    // --pack-segments：.got、.bss 依次紧跟 .data；只有权限相同的段才共用页，权限变化处仍从新页开始
+    st.code_with_rodata = !options.separate_code && !options.huge_text;
+    st.text_base = BASE_ADDR;
+    uint64_t text_align = options.huge_text ? FLE_HUGE_PAGE_SIZE : 4096;
+    st.text_mem_size = align_up(st.text_data.size() + st.plt_size, text_align);
+    st.plt_base = st.text_base + st.text_data.size();
+    st.rodata_base = st.code_with_rodata ? align_up(st.text_base + st.text_data.size() + st.plt_size, st.rodata_align) : st.text_base + st.text_mem_size;
+    st.data_base = align_up(st.rodata_base + st.rodata_data.size(), 4096);
+    st.got_base = options.pack_segments ? align_up(st.data_base + st.original_data_size, 8) : align_up(st.data_base + st.original_data_size, 4096);
+    st.bss_base = options.pack_segments ? align_up(st.got_base + st.got_bytes, st.bss_align) : align_up(st.got_base + st.got_bytes, 4096);
+
+    // TLS 块以线程指针结尾：符号的 TPOFF = 地址 - tls_tp（为负数）
+    st.tls_vaddr = st.rodata_base + st.tls_start;
+    st.tls_tp = st.tls_vaddr + align_up(st.tls_memsz, FLE_TLS_ALIGN);
+
+    // 构造映射（节 -> 虚拟地址与输出缓冲区偏移）；被 --icf 折叠的节使用保留节的地址
+    st.rodata_file = st.text_data.size() + st.plt_size;
+    st.data_file = st.rodata_file + st.rodata_data.size();
+    for (const auto& pm : st.pending) {
+        uint64_t base = 0;
+        size_t file = SIZE_MAX;
+        if (pm.cat == "text") base = st.text_base, file = 0;
+        else if (pm.cat == "rodata" || pm.cat == "tdata") base = st.rodata_base, file = st.rodata_file;
+        else if (pm.cat == "tbss") base = st.rodata_base + st.tls_start;
+        else if (pm.cat == "data") base = st.data_base, file = st.data_file;
+        else base = st.bss_base;
+        st.mappings.push_back({ base + pm.seg_offset, pm.sec, pm.obj, pm.name, file == SIZE_MAX ? SIZE_MAX : file + pm.seg_offset });
+        st.section_addr.emplace(SectionKey{ pm.obj, pm.name }, base + pm.seg_offset);
+    }
+    for (const auto& [from, to] : st.folded) {
+        auto it = st.section_addr.find(to);
+        if (it != st.section_addr.end()) st.section_addr.emplace(from, it->second);
+    }
+
+    for (auto* objp : st.active) {
+        for (const auto& sym : objp->symbols) {
             if (sym.section.empty()) continue;
-            uint64_t base = find_base(objp, sym.section);
-            if (base == 0) continue;
-            uint64_t addr = base + sym.offset;
+            uint64_t addr = st.symbol_addr(objp, sym);
+            if (addr == 0) continue;
             if (sym.type == SymbolType::LOCAL) {
-                locals[objp][sym.name] = addr;
+                st.locals[objp][sym.name] = addr;
             } else {
-                auto it = globals.find(sym.name);
-                if (it == globals.end()) globals.emplace(sym.name, GlobalSym{ sym.type, addr });
-                else {
-                    if (it->second.type == SymbolType::GLOBAL && sym.type == SymbolType::GLOBAL)
-                        throw runtime_error("Multiple definition of strong symbol: " + sym.name);
-                    else if (it->second.type == SymbolType::WEAK && sym.type == SymbolType::GLOBAL)
-                        it->second = GlobalSym{ SymbolType::GLOBAL, addr };
-                }
+                auto it = st.globals.find(sym.name);
+                if (it == st.globals.end()) st.globals.emplace(sym.name, GlobalSym{ sym.type, addr, sym.ifunc });
+                else if (it->second.type == SymbolType::WEAK && sym.type == SymbolType::GLOBAL)
+                    it->second = GlobalSym{ SymbolType::GLOBAL, addr, sym.ifunc };
             }
         }
     }
+}
 
-    // 3) 重定位：内部立即解析；EXE 的外部通过 PLT/GOT，SO 的外部记录为动态重定位
+// 4) 重定位：内部立即解析；EXE 的外部通过 PLT/GOT，SO 的外部记录为动态重定位
+static void apply_relocations(LinkState& st)
+{
     // 先构建输出缓冲区骨架：.text | .plt | .rodata | .data（.got 追加到 .data 尾部）
-    uint64_t plt_base = text_base + text_data.size();
-
-    vector<uint8_t> output_data;
-    output_data.reserve(text_data.size() + plt_size + rodata_data.size() + data_data.size());
+    auto& output_data = st.output_data;
+    output_data.reserve(st.text_data.size() + st.plt_size + st.rodata_data.size() + st.data_data.size());
     // text
-    output_data.insert(output_data.end(), text_data.begin(), text_data.end());
+    output_data.insert(output_data.end(), st.text_data.begin(), st.text_data.end());
     // plt（先占位，稍后回填）
-    if (plt_size) output_data.insert(output_data.end(), plt_size, 0);
+    if (st.plt_size) output_data.insert(output_data.end(), st.plt_size, 0);
     // rodata
-    output_data.insert(output_data.end(), rodata_data.begin(), rodata_data.end());
+    output_data.insert(output_data.end(), st.rodata_data.begin(), st.rodata_data.end());
     // data
-    output_data.insert(output_data.end(), data_data.begin(), data_data.end());
+    output_data.insert(output_data.end(), st.data_data.begin(), st.data_data.end());
     // got（单独节，便于判定）
-    vector<uint8_t> got_data;
-    if (got_bytes) got_data.resize(got_bytes, 0);
-    if (got_bytes) output_data.insert(output_data.end(), got_data.begin(), got_data.end());
-
-    auto lookup_addr = [&](const FLEObject* obj, const string& name) -> uint64_t {
-        auto lit = locals.find(obj);   
-        if (lit != locals.end()) {
-            auto fit = lit->second.find(name);  
-            if (fit != lit->second.end()) return fit->second;
-        }
-        auto git = globals.find(name);
-        if (git != globals.end()) return git->second.addr;
-        throw runtime_error("Undefined symbol: " + name);
-    };
+    if (st.got_bytes) st.got_data.resize(st.got_bytes, 0);
+    if (st.got_bytes) output_data.insert(output_data.end(), st.got_data.begin(), st.got_data.end());
 
     auto write32 = [&](size_t off, uint32_t v) {
         if (off + 4 > output_data.size()) return;
@@ -254,29 +1098,26 @@ FLEObject FLE_ld(const vector<FLEObject>& objects, const LinkerOptions& options)
         for (int i = 0; i < 8; ++i) output_data[off + i] = static_cast<uint8_t>((v >> (8 * i)) & 0xff);
     };
 
-    auto is_internal = [&](const FLEObject* obj, const string& name) -> bool {
-        auto lit = locals.find(obj);
-        if (lit != locals.end() && lit->second.count(name)) return true;
-        return globals.count(name) > 0;
-    };
-
-    vector<Relocation> dyn_relocs_out;
-
-    for (const auto& mp : mappings) {
+    for (const auto& mp : st.mappings) {
         const FLEObject* obj = mp.parent_obj;
         for (const auto& reloc : mp.original_section->relocs) {
             int64_t A = reloc.addend;
-            // 计算 P 与补丁偏移：按段拼接顺序
+            // 以"节符号 + 偏移"引用合并节时，偏移指向的那一项可能已经移动：按项重新计算加数。
+            // 能走到这里的只有绝对引用（见 pc_relative_refs），加数就是节内偏移
+            auto mit = st.merged_pieces.find({ obj, reloc.symbol });
+            if (mit != st.merged_pieces.end()) {
+                uint64_t target = st.rodata_base + merged_offset(mit->second, static_cast<uint64_t>(A));
+                A = static_cast<int64_t>(target) - static_cast<int64_t>(st.lookup_addr(obj, reloc.symbol));
+            }
+            // P 与补丁偏移（bss 无文件内容）
             uint64_t P = mp.vaddr + reloc.offset;
-            size_t patch = 0;
-            if (mp.vaddr >= text_base && mp.vaddr < rodata_base) patch = (mp.vaddr - text_base) + reloc.offset;
-            else if (mp.vaddr >= rodata_base && mp.vaddr < data_base) patch = text_data.size() + plt_size + (mp.vaddr - rodata_base) + reloc.offset;
-            else if (mp.vaddr >= data_base && mp.vaddr < bss_base) patch = text_data.size() + plt_size + rodata_data.size() + (mp.vaddr - data_base) + reloc.offset;
-            else patch = SIZE_MAX; // bss 无文件内容
-            bool internal = is_internal(obj, reloc.symbol);
-            if (options.shared) {
-                if (internal && !so_defined_globals.count(reloc.symbol)) {
-                    uint64_t S = lookup_addr(obj, reloc.symbol);
+            size_t patch = mp.file_offset == SIZE_MAX ? SIZE_MAX : mp.file_offset + reloc.offset;
+            bool internal = st.is_internal(obj, reloc.symbol);
+            bool ifunc = st.is_ifunc(obj, reloc.symbol);
+            if (st.options.shared) {
+                // 库内对 IFUNC 的引用同样留给加载器，在解析函数选定实现后再填写
+                if (internal && !ifunc && !st.so_defined_globals.count(reloc.symbol)) {
+                    uint64_t S = st.lookup_addr(obj, reloc.symbol);
                     switch (reloc.type) {
                         case RelocationType::R_X86_64_32:
                         case RelocationType::R_X86_64_32S: {
@@ -294,15 +1135,25 @@ FLEObject FLE_ld(const vector<FLEObject>& objects, const LinkerOptions& options)
                             if (patch != SIZE_MAX) write64(patch, V);
                             break;
                         }
+                        case RelocationType::R_X86_64_GOTPCREL:
+                            st.dyn_relocs_out.push_back(Relocation{ reloc.type, (size_t)P, reloc.symbol, A });
+                            break;
+                        case RelocationType::R_X86_64_GOTPCRELX: {
+                            // 共享库没有 GOT：能松弛的直接引用，其余仍交给加载器
+                            if (patch != SIZE_MAX && is_relaxable_gotpcrel(output_data, patch, A)) relax_gotpcrel(output_data, patch, S, P);
+                            else st.dyn_relocs_out.push_back(Relocation{ RelocationType::R_X86_64_GOTPCREL, (size_t)P, reloc.symbol, A });
+                            break;
+                        }
                         default: break;
                     }
                 } else {
-                    // 外部：留给加载器
-                    dyn_relocs_out.push_back(Relocation{ reloc.type, (size_t)P, reloc.symbol, A });
+                    // 外部：留给加载器（加载器不区分 GOTPCRELX）
+                    RelocationType type = is_gotpcrel(reloc.type) ? RelocationType::R_X86_64_GOTPCREL : reloc.type;
+                    st.dyn_relocs_out.push_back(Relocation{ type, (size_t)P, reloc.symbol, A });
                 }
             } else {
-                if (internal) {
-                    uint64_t S = lookup_addr(obj, reloc.symbol);
+                if (internal && !ifunc) {
+                    uint64_t S = st.lookup_addr(obj, reloc.symbol);
                     switch (reloc.type) {
                         case RelocationType::R_X86_64_32:
                         case RelocationType::R_X86_64_32S: {
@@ -320,28 +1171,55 @@ FLEObject FLE_ld(const vector<FLEObject>& objects, const LinkerOptions& options)
                             if (patch != SIZE_MAX) write64(patch, V);
                             break;
                         }
+                        case RelocationType::R_X86_64_TPOFF32: {
+                            int64_t V = static_cast<int64_t>(S) + A - static_cast<int64_t>(st.tls_tp);
+                            if (patch != SIZE_MAX) write32(patch, static_cast<uint32_t>(static_cast<int32_t>(V)));
+                            break;
+                        }
+                        case RelocationType::R_X86_64_GOTTPOFF: {
+                            uint64_t got_slot = st.got_base + st.got_index.at(reloc.symbol) * 8;
+                            int64_t V = static_cast<int64_t>(got_slot) + A - static_cast<int64_t>(P);
+                            if (patch != SIZE_MAX) write32(patch, static_cast<uint32_t>(static_cast<int32_t>(V)));
+                            break;
+                        }
+                        case RelocationType::R_X86_64_GOTPCREL:
+                        case RelocationType::R_X86_64_GOTPCRELX: {
+                            if (patch == SIZE_MAX) break;
+                            if (reloc.type == RelocationType::R_X86_64_GOTPCRELX && is_relaxable_gotpcrel(output_data, patch, A)) {
+                                relax_gotpcrel(output_data, patch, S, P);
+                            } else {
+                                uint64_t got_slot = st.got_base + st.local_got_index.at(st.local_got_key(obj, reloc.symbol)) * 8;
+                                write32(patch, static_cast<uint32_t>(static_cast<int32_t>(static_cast<int64_t>(got_slot) + A - static_cast<int64_t>(P))));
+                            }
+                            break;
+                        }
                         default: break;
                     }
                 } else {
-                    bool provided_by_shared = so_defined_globals.count(reloc.symbol) > 0;
-                    if (!provided_by_shared) {
+                    bool provided_by_shared = st.so_defined_globals.count(reloc.symbol) > 0;
+                    if (!provided_by_shared && !ifunc) {
                         throw runtime_error("Undefined symbol: " + reloc.symbol);
                     }
-                    // EXE 的外部：PC32 -> PLT；GOTPCREL -> GOT 槽
+                    // EXE 的外部：PC32 -> PLT；GOTPCREL -> GOT 槽；IFUNC 的绝对地址 -> PLT 桩
                     if (reloc.type == RelocationType::R_X86_64_PC32) {
-                        auto it = got_index.find(reloc.symbol);
-                        if (it == got_index.end()) continue;
+                        auto it = st.got_index.find(reloc.symbol);
+                        if (it == st.got_index.end()) continue;
                         size_t idx = it->second;
-                        uint64_t stub_addr = plt_base + idx * 6;
+                        uint64_t stub_addr = st.plt_base + idx * 6;
                         int32_t V = (int32_t)((int64_t)stub_addr + A - (int64_t)P);
                         if (patch != SIZE_MAX) write32(patch, (uint32_t)V);
-                    } else if (reloc.type == RelocationType::R_X86_64_GOTPCREL) {
-                        auto it = got_index.find(reloc.symbol);
-                        if (it == got_index.end()) continue;
+                    } else if (is_gotpcrel(reloc.type)) {
+                        auto it = st.got_index.find(reloc.symbol);
+                        if (it == st.got_index.end()) continue;
                         size_t idx = it->second;
-                        uint64_t got_slot = got_base + idx * 8;
+                        uint64_t got_slot = st.got_base + idx * 8;
                         int32_t V = (int32_t)((int64_t)got_slot + A - (int64_t)P);
                         if (patch != SIZE_MAX) write32(patch, (uint32_t)V);
+                    } else if (ifunc && st.got_index.count(reloc.symbol)) {
+                        uint64_t V = st.plt_base + st.got_index.at(reloc.symbol) * 6 + A;
+                        if (patch == SIZE_MAX) continue;
+                        if (reloc.type == RelocationType::R_X86_64_64) write64(patch, V);
+                        else write32(patch, static_cast<uint32_t>(V));
                     } else {
                         throw runtime_error("Undefined symbol: " + reloc.symbol);
                     }
@@ -350,28 +1228,110 @@ FLEObject FLE_ld(const vector<FLEObject>& objects, const LinkerOptions& options)
         }
     }
 
-    // 4) 生成输出文件（多段 + 权限 + 对齐 + BSS）
+    // initial-exec 的 GOT 槽在链接时即可确定，直接写入线程指针偏移
+    for (const auto& name : st.tls_got) {
+        auto git = st.globals.find(name);
+        if (git == st.globals.end()) throw runtime_error("Undefined symbol: " + name);
+        int64_t tpoff = static_cast<int64_t>(git->second.addr) - static_cast<int64_t>(st.tls_tp);
+        size_t off = st.got_index.at(name) * 8;
+        for (int i = 0; i < 8; ++i) st.got_data[off + i] = static_cast<uint8_t>((static_cast<uint64_t>(tpoff) >> (8 * i)) & 0xff);
+    }
+
+    // 本模块内符号的 GOT 槽：地址在链接时已知，直接写入
+    for (const auto& [key, idx] : st.local_got_index) {
+        uint64_t addr = st.lookup_addr(key.first, key.second);
+        size_t off = idx * 8;
+        for (int i = 0; i < 8; ++i) st.got_data[off + i] = static_cast<uint8_t>((addr >> (8 * i)) & 0xff);
+    }
+}
+
+// 导出本模块定义的全局/弱符号（TLS 符号除外），节名与偏移改为所在的输出段
+static void export_symbols(const LinkState& st, FLEObject& output)
+{
+    for (auto* objp : st.active) {
+        for (const auto& sym : objp->symbols) {
+            if (sym.section.empty()) continue;
+            if (sym.type != SymbolType::GLOBAL && sym.type != SymbolType::WEAK) continue;
+            if (sym.section.rfind(".tdata", 0) == 0 || sym.section.rfind(".tbss", 0) == 0) continue; // TLS 符号不导出
+            uint64_t addr = st.symbol_addr(objp, sym);
+            if (addr == 0) continue;
+            string cat = cat_of(sym.section);
+            output.symbols.push_back(Symbol{ sym.type, "." + cat, addr - st.segment_base(cat), sym.size, sym.name, sym.ifunc });
+        }
+    }
+}
+
+// 可执行文件的 GOT 槽动态重定位、依赖、延迟加载的库、TLS 与入口点
+static void finish_executable(const LinkState& st, FLEObject& output)
+{
+    const LinkerOptions& options = st.options;
+    // 为每个 GOT 槽生成动态重定位（在加载时填地址）；
+    // 本地定义的 IFUNC 槽记录解析函数地址，由加载器调用它得到实现地址
+    for (const auto& kv : st.got_index) {
+        if (st.tls_got.count(kv.first)) continue;
+        size_t idx = kv.second;
+        uint64_t slot_vaddr = st.got_base + idx * 8;
+        auto git = st.globals.find(kv.first);
+        if (git != st.globals.end() && git->second.ifunc)
+            output.dyn_relocs.push_back(Relocation{ RelocationType::R_X86_64_IRELATIVE, (size_t)slot_vaddr, kv.first, (int64_t)git->second.addr });
+        else
+            output.dyn_relocs.push_back(Relocation{ RelocationType::R_X86_64_64, (size_t)slot_vaddr, kv.first, 0 });
+    }
+    // 导出 EXE 中已定义的全局/弱符号，供 SO 解析使用
+    export_symbols(st, output);
+    // 记录依赖的共享库
+    for (auto* so : st.shared_deps) if (!so->name.empty()) output.needed.push_back(so->name);
+    // 延迟加载：只经由 PLT 调用的函数可以在首次调用时再绑定；
+    // 若可执行文件通过 GOT 引用了库中的数据，该库仍在启动时加载
+    if (!options.lazy_libs.empty()) {
+        map<string, vector<string>> lazy;
+        set<string> eager;
+        for (const auto& kv : st.got_index) {
+            const string& name = kv.first;
+            if (st.globals.count(name)) continue;
+            const FLEObject* provider = nullptr;
+            for (auto* so : st.shared_deps) {
+                for (const auto& sym : so->symbols) {
+                    if (sym.name == name && !sym.section.empty() && sym.type != SymbolType::LOCAL) { provider = so; break; }
+                }
+                if (provider) break;
+            }
+            if (!provider || !options.lazy_libs.count(provider->name)) continue;
+            if (st.extern_funcs.count(name) && !st.extern_datas.count(name)) lazy[provider->name].push_back(name);
+            else eager.insert(provider->name);
+        }
+        for (auto* so : st.shared_deps) {
+            if (options.lazy_libs.count(so->name) && !eager.count(so->name)) output.lazy[so->name] = lazy[so->name];
+        }
+    }
+    if (st.has_tls) output.tls = TLSHeader{ st.tls_vaddr, st.tls_filesz, st.tls_memsz, FLE_TLS_ALIGN };
+    // 入口点
+    string entry = options.entryPoint.empty() ? string("_start") : options.entryPoint;
+    auto ge = st.globals.find(entry);
+    output.entry = (ge != st.globals.end()) ? ge->second.addr : 0;
+}
+
+// 5) 生成输出文件（多段 + 权限 + 对齐 + BSS）
+static FLEObject build_output(const LinkState& st)
+{
+    const LinkerOptions& options = st.options;
+    const auto& output_data = st.output_data;
     // 使用已重定位后的数据切片
-    vector<uint8_t> text_patched;
-    vector<uint8_t> plt_patched;
-    vector<uint8_t> rodata_patched;
-    vector<uint8_t> data_patched;
-    text_patched.insert(text_patched.end(), output_data.begin(), output_data.begin() + text_data.size());
-    if (plt_size) plt_patched.insert(plt_patched.end(), output_data.begin() + text_data.size(), output_data.begin() + text_data.size() + plt_size);
-    rodata_patched.insert(rodata_patched.end(), output_data.begin() + text_data.size() + plt_size, output_data.begin() + text_data.size() + plt_size + rodata_data.size());
-    data_patched.insert(data_patched.end(), output_data.begin() + text_data.size() + plt_size + rodata_data.size(), output_data.end());
-//这个怎么push呀呀
-    // 构建 PLT stub：写入 GOT 相对偏移
-    if (plt_size) {
-        for (const auto& kv : got_index) {
+    vector<uint8_t> text_with_plt(output_data.begin(), output_data.begin() + st.rodata_file);
+    vector<uint8_t> rodata_patched(output_data.begin() + st.rodata_file, output_data.begin() + st.data_file);
+    vector<uint8_t> data_patched(output_data.begin() + st.data_file, output_data.begin() + st.data_file + st.original_data_size);
+
+    // 构建 PLT stub：写入 GOT 相对偏移。.plt 直接并入 .text 的数据末尾，避免非页对齐映射
+    if (st.plt_size) {
+        for (const auto& kv : st.got_index) {
             size_t idx = kv.second;
-            uint64_t stub_addr = plt_base + idx * 6;
-            uint64_t got_slot = got_base + idx * 8;
+            uint64_t stub_addr = st.plt_base + idx * 6;
+            uint64_t got_slot = st.got_base + idx * 8;
             int32_t rel = (int32_t)((int64_t)got_slot - (int64_t)(stub_addr + 6));
             auto stub = generate_plt_stub(rel);
             size_t off = idx * 6;
-            if (off + 6 <= plt_patched.size()) {
-                for (int i = 0; i < 6; ++i) plt_patched[off + i] = stub[i];
+            if (off + 6 <= st.plt_size) {
+                for (int i = 0; i < 6; ++i) text_with_plt[st.text_data.size() + off + i] = stub[i];
             }
         }
     }
@@ -380,81 +1340,99 @@ FLEObject FLE_ld(const vector<FLEObject>& objects, const LinkerOptions& options)
     output.name = options.outputFile.empty() ? (options.shared ? "lib.so" : "a.out") : options.outputFile;
     output.type = options.shared ? ".so" : ".exe";
 
-    // 将 .plt 直接并入 .text 的数据末尾，避免非页对齐映射
-    vector<uint8_t> text_with_plt = text_patched;
-    if (plt_size) text_with_plt.insert(text_with_plt.end(), plt_patched.begin(), plt_patched.end());
     FLESection s_text; s_text.name = ".text"; s_text.data = text_with_plt; s_text.has_symbols = false; output.sections[".text"] = s_text;
     FLESection s_rodata; s_rodata.name = ".rodata"; s_rodata.data = rodata_patched; s_rodata.has_symbols = false; output.sections[".rodata"] = s_rodata;
+    // --pack-segments：GOT 并入 .data 段尾部，不再单独占页
+    if (options.pack_segments && st.got_bytes) {
+        data_patched.resize(st.got_base - st.data_base, 0);
+        data_patched.insert(data_patched.end(), st.got_data.begin(), st.got_data.end());
+    }
     FLESection s_data; s_data.name = ".data"; s_data.data = data_patched; s_data.has_symbols = false; output.sections[".data"] = s_data;
-    if (got_bytes) { FLESection s_got; s_got.name = ".got"; s_got.data = got_data; s_got.has_symbols = false; output.sections[".got"] = s_got; }
-    FLESection s_bss; s_bss.name = ".bss"; s_bss.data.assign(static_cast<size_t>(bss_size), 0); s_bss.has_symbols = false; output.sections[".bss"] = s_bss;
-
-    ProgramHeader ph_text; ph_text.name = ".text"; ph_text.vaddr = text_base; ph_text.size = text_data.size() + plt_size; ph_text.flags = PHF::R | PHF::X;
-    ProgramHeader ph_rodata; ph_rodata.name = ".rodata"; ph_rodata.vaddr = rodata_base; ph_rodata.size = rodata_data.size(); ph_rodata.flags = static_cast<uint32_t>(PHF::R);
-    ProgramHeader ph_data; ph_data.name = ".data"; ph_data.vaddr = data_base; ph_data.size = data_data.size(); ph_data.flags = PHF::R | PHF::W;
-    ProgramHeader ph_got; if (got_bytes) { ph_got.name = ".got"; ph_got.vaddr = got_base; ph_got.size = got_bytes; ph_got.flags = PHF::R | PHF::W; }
-    ProgramHeader ph_bss; ph_bss.name = ".bss"; ph_bss.vaddr = bss_base; ph_bss.size = bss_size; ph_bss.flags = PHF::R | PHF::W;
+    if (st.got_bytes && !options.pack_segments) { FLESection s_got; s_got.name = ".got"; s_got.data = st.got_data; s_got.has_symbols = false; output.sections[".got"] = s_got; }
+    // .bss 为 NOBITS：只保留节名，大小由程序头给出，加载器依赖匿名映射清零
+    FLESection s_bss; s_bss.name = ".bss"; s_bss.has_symbols = false; output.sections[".bss"] = s_bss;
+
+    ProgramHeader ph_text; ph_text.name = ".text"; ph_text.vaddr = st.text_base; ph_text.size = options.huge_text ? st.text_mem_size : st.text_data.size() + st.plt_size; ph_text.flags = PHF::R | PHF::X;
+    ProgramHeader ph_rodata; ph_rodata.name = ".rodata"; ph_rodata.vaddr = st.rodata_base; ph_rodata.size = st.rodata_data.size(); ph_rodata.flags = st.code_with_rodata ? PHF::R | PHF::X : static_cast<uint32_t>(PHF::R);
+    ProgramHeader ph_data; ph_data.name = ".data"; ph_data.vaddr = st.data_base; ph_data.size = data_patched.size(); ph_data.flags = PHF::R | PHF::W;
+    ProgramHeader ph_got; if (st.got_bytes && !options.pack_segments) { ph_got.name = ".got"; ph_got.vaddr = st.got_base; ph_got.size = st.got_bytes; ph_got.flags = PHF::R | PHF::W; }
+    ProgramHeader ph_bss; ph_bss.name = ".bss"; ph_bss.vaddr = st.bss_base; ph_bss.size = st.bss_size; ph_bss.flags = PHF::R | PHF::W;
     output.phdrs.push_back(ph_text);
     output.phdrs.push_back(ph_rodata);
     output.phdrs.push_back(ph_data);
-    if (got_bytes) output.phdrs.push_back(ph_got);
+    if (st.got_bytes && !options.pack_segments) output.phdrs.push_back(ph_got);
     output.phdrs.push_back(ph_bss);
 
+    // 二进制段布局：为有文件内容的段分配镜像偏移（与 vaddr 模页大小同余，便于直接 mmap）。
+    // 与上一段共用页的段在镜像中紧接其后，两段映射同一文件页时内容一致
+    if (options.binary_segments) {
+        uint64_t cursor = 0;
+        const ProgramHeader* prev = nullptr;
+        for (auto& ph : output.phdrs) {
+            auto it = output.sections.find(ph.name);
+            if (ph.name == ".bss" || it == output.sections.end() || it->second.data.empty()) continue;
+            if (prev && ph.vaddr / FLE_IMAGE_ALIGN == (prev->vaddr + prev->filesz - 1) / FLE_IMAGE_ALIGN)
+                cursor = prev->offset + (ph.vaddr - prev->vaddr);
+            else
+                cursor = align_up(cursor, FLE_IMAGE_ALIGN) + ph.vaddr % FLE_IMAGE_ALIGN;
+            prev = &ph;
+            ph.offset = cursor;
+            ph.filesz = it->second.data.size();
+            cursor += ph.filesz;
+        }
+    }
+
     // 导出符号（共享库）与动态重定位/依赖（可执行）
     if (options.shared) {
-        // 导出已定义的全局/弱
-        auto find_base = [&](const FLEObject* obj, const string& secname) -> uint64_t {
-            for (const auto& mp : mappings) if (mp.parent_obj == obj && mp.name == secname) return mp.vaddr;
-            return 0;
-        };
-        for (auto* objp : active) {
-            for (const auto& sym : objp->symbols) {
-                if (sym.section.empty()) continue;
-                if (sym.type != SymbolType::GLOBAL && sym.type != SymbolType::WEAK) continue;
-                uint64_t base = find_base(objp, sym.section);
-                if (base == 0) continue;
-                string cat = (sym.section.rfind(".text",0)==0?"text":(sym.section.rfind(".rodata",0)==0?"rodata":(sym.section.rfind(".data",0)==0?"data":"bss")));
-                string out_sec = cat=="text"?".text":(cat=="rodata"?".rodata":(cat=="data"?".data":".bss"));
-                uint64_t out_base = (cat=="text"?text_base:(cat=="rodata"?rodata_base:(cat=="data"?data_base:bss_base)));
-                size_t off = (size_t)((base + sym.offset) - out_base);
-                output.symbols.push_back(Symbol{ sym.type, out_sec, off, sym.size, sym.name });
-            }
-        }
-        output.dyn_relocs = dyn_relocs_out;
+        export_symbols(st, output);
+        output.dyn_relocs = st.dyn_relocs_out;
         // 记录共享库依赖
-        for (auto* so : shared_deps) if (!so->name.empty()) output.needed.push_back(so->name);
+        for (auto* so : st.shared_deps) if (!so->name.empty()) output.needed.push_back(so->name);
     } else {
-        // 为每个 GOT 槽生成动态重定位（在加载时填地址）
-        for (const auto& kv : got_index) {
-            size_t idx = kv.second;
-            uint64_t slot_vaddr = got_base + idx * 8;
-            output.dyn_relocs.push_back(Relocation{ RelocationType::R_X86_64_64, (size_t)slot_vaddr, kv.first, 0 });
-        }
-        // 导出 EXE 中已定义的全局/弱符号，供 SO 解析使用
-        auto find_base = [&](const FLEObject* obj, const string& secname) -> uint64_t {
-            for (const auto& mp : mappings) if (mp.parent_obj == obj && mp.name == secname) return mp.vaddr;
-            return 0;
-        };
-        for (auto* objp : active) {
-            for (const auto& sym : objp->symbols) {
-                if (sym.section.empty()) continue;
-                if (sym.type != SymbolType::GLOBAL && sym.type != SymbolType::WEAK) continue;
-                uint64_t base = find_base(objp, sym.section);
-                if (base == 0) continue;
-                string cat = (sym.section.rfind(".text",0)==0?"text":(sym.section.rfind(".rodata",0)==0?"rodata":(sym.section.rfind(".data",0)==0?"data":"bss")));
-                string out_sec = cat=="text"?".text":(cat=="rodata"?".rodata":(cat=="data"?".data":".bss"));
-                uint64_t out_base = (cat=="text"?text_base:(cat=="rodata"?rodata_base:(cat=="data"?data_base:bss_base)));
-                size_t off = (size_t)((base + sym.offset) - out_base);
-                output.symbols.push_back(Symbol{ sym.type, out_sec, off, sym.size, sym.name });
-            }
-        } 
-        // 记录依赖的共享库
-        for (auto* so : shared_deps) if (!so->name.empty()) output.needed.push_back(so->name);
-        // 入口点
-        string entry = options.entryPoint.empty() ? string("_start") : options.entryPoint;
-        auto ge = globals.find(entry);
-        output.entry = (ge != globals.end()) ? ge->second.addr : 0;
+        finish_executable(st, output);
     }
+    return output;
+}
+
+FLEObject FLE_ld(const vector<FLEObject>& objects, const LinkerOptions& options)
+{
+    LinkState st(options);
+
+    scan_inputs(st, objects);
+    st.end_phase("input scan");
+
+    resolve_symbols(st);
+    st.end_phase("symbol resolution");
+
+    // 节筛选
+    if (options.gc_sections) gc_sections(st);
+    if (options.icf != "none") fold_identical_sections(st);
+    st.end_phase("section selection");
 
+    size_synthetic_sections(st);
+    st.end_phase("synthetic sections");
+
+    // 3) 布局：排列并合并节到多段 text/rodata/data/bss，再确定各段地址
+    order_sections(st);
+    place_sections(st);
+    merge_constants(st);
+    place_tls(st);
+    assign_addresses(st);
+    st.end_phase("layout");
+
+    apply_relocations(st);
+    st.end_phase("relocation");
+
+    FLEObject output = build_output(st);
+    st.end_phase("output");
+
+    if (options.print_stats) {
+        double total_ms = chrono::duration<double, milli>(LinkState::Clock::now() - st.link_begin).count();
+        cerr << fixed << setprecision(3) << "ld statistics:\n";
+        for (const auto& [name, ms] : st.phase_ms) cerr << "  " << left << setw(22) << name << right << setw(10) << ms << " ms\n";
+        cerr << "  " << left << setw(22) << "total" << right << setw(10) << total_ms << " ms\n";
+        cerr << "  PLT stubs: " << st.plt_size / 6 << ", GOT slots: " << st.got_bytes / 8 << " (" << st.local_got.size() + st.tls_got.size()
+             << " filled at link time), dynamic relocations: " << output.dyn_relocs.size() << endl;
+    }
     return output;
 }
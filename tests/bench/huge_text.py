@@ -0,0 +1,168 @@
+#!/usr/bin/env python3
+"""
+大页代码段基准测试：生成一个代码段很大的合成程序，分别以 4 KiB 页和
+2 MiB 大页 (ld --huge-text + exec --huge-pages) 运行并比较。
+
+每个函数体用 .skip 撑到约一页，主循环按跨步顺序调用所有函数，
+使每次调用都落在不同的代码页上，从而放大 iTLB 压力。
+
+用法（在仓库根目录）：
+    python3 tests/bench/huge_text.py [--funcs N] [--iters N] [--repeat N]
+
+如果系统中有 perf，会额外报告 iTLB-load-misses；否则只比较运行时间。
+"""
+import argparse
+import os
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+import time
+
+ROOT = os.path.dirname(os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+COMMON = os.path.join(ROOT, "tests", "common")
+
+
+def generate_source(funcs, iters):
+    lines = ['#include "minilibc.h"', ""]
+    for i in range(funcs):
+        lines.append(f"__attribute__((noinline)) int f{i}(int x)")
+        lines.append("{")
+        lines.append('    __asm__ volatile("jmp 1f\\n.skip 4000, 0xcc\\n1:");')
+        lines.append(f"    return x + {i};")
+        lines.append("}")
+    lines.append("")
+    lines.append("typedef int (*fn_t)(int);")
+    lines.append("static fn_t table[] = {")
+    lines.append(",\n".join(f"    f{i}" for i in range(funcs)))
+    lines.append("};")
+    lines.append("")
+    lines.append(f"""static char smaps[1 << 16];
+
+static char* find(char* s, const char* needle)
+{{
+    for (; *s; s++) {{
+        int i = 0;
+        while (needle[i] && s[i] == needle[i])
+            i++;
+        if (!needle[i])
+            return s;
+    }}
+    return 0;
+}}
+
+// 报告 0x400000 处代码段映射实际获得的 AnonHugePages
+static void report_huge_pages(void)
+{{
+    long fd = syscall(SYS_open, "/proc/self/smaps", 0, 0);
+    if (fd < 0)
+        return;
+    long total = 0, n;
+    while ((n = syscall(SYS_read, fd, smaps + total, sizeof(smaps) - 1 - total)) > 0)
+        total += n;
+    smaps[total] = '\\0';
+    syscall(SYS_close, fd);
+    char* text = find(smaps, "00400000-");
+    if (!text)
+        return;
+    char* huge = find(text, "AnonHugePages:");
+    if (!huge)
+        return;
+    char* end = strchr(huge, '\\n');
+    if (end)
+        *end = '\\0';
+    print(huge, NULL);
+    print("\\n", NULL);
+}}
+
+int main()
+{{
+    int acc = 0;
+    const int count = sizeof(table) / sizeof(table[0]);
+    for (int it = 0; it < {iters}; it++) {{
+        // 跨步 97 遍历，打乱顺序以避免硬件预取掩盖 iTLB 开销
+        int idx = 0;
+        for (int k = 0; k < count; k++) {{
+            acc = table[idx](acc);
+            idx += 97;
+            if (idx >= count)
+                idx -= count;
+        }}
+    }}
+    report_huge_pages();
+    printf("checksum: %d\\n", acc);
+    return 0;
+}}""")
+    return "\n".join(lines) + "\n"
+
+
+def run(cmd, **kwargs):
+    result = subprocess.run(cmd, capture_output=True, text=True, **kwargs)
+    if result.returncode != 0:
+        sys.exit(f"command failed: {' '.join(cmd)}\n{result.stdout}{result.stderr}")
+    return result
+
+
+def measure(cmd, repeat, perf):
+    best = None
+    output = ""
+    misses = None
+    for _ in range(repeat):
+        start = time.perf_counter()
+        result = run(cmd)
+        elapsed = time.perf_counter() - start
+        best = elapsed if best is None else min(best, elapsed)
+        output = result.stdout
+    if perf:
+        result = subprocess.run([perf, "stat", "-x,", "-e", "iTLB-load-misses"] + cmd, capture_output=True, text=True)
+        match = re.search(r"^(\d+),", result.stderr, re.MULTILINE)
+        misses = int(match.group(1)) if match else None
+    return best, output, misses
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compare 4 KiB and 2 MiB text pages")
+    parser.add_argument("--funcs", type=int, default=4096, help="number of ~4 KiB functions (default 4096 = 16 MiB text)")
+    parser.add_argument("--iters", type=int, default=2000, help="passes over all functions")
+    parser.add_argument("--repeat", type=int, default=3, help="runs per configuration, best time is reported")
+    args = parser.parse_args()
+
+    cc, ld, exe = (os.path.join(ROOT, tool) for tool in ("cc", "ld", "exec"))
+    perf = shutil.which("perf")
+
+    with tempfile.TemporaryDirectory() as work:
+        src = os.path.join(work, "bigtext.c")
+        with open(src, "w") as f:
+            f.write(generate_source(args.funcs, args.iters))
+        print(f"building synthetic program with {args.funcs} functions...", flush=True)
+        run([cc, src, "-o", os.path.join(work, "bigtext.o"), f"-I{COMMON}", "-O2"])
+        objs = [os.path.join(work, "bigtext.fo"), os.path.join(COMMON, "minilibc.fo")]
+        small = os.path.join(work, "small")
+        huge = os.path.join(work, "huge")
+        run([ld, "--binary-segments"] + objs + ["-o", small])
+        run([ld, "--binary-segments", "--huge-text"] + objs + ["-o", huge])
+
+        configs = [
+            ("4 KiB pages", [exe, small]),
+            ("2 MiB pages", [exe, "--huge-pages", huge]),
+        ]
+        results = []
+        for name, cmd in configs:
+            print(f"running {name}...", flush=True)
+            results.append((name,) + measure(cmd, args.repeat, perf))
+
+    print()
+    print(f"{'configuration':<16}{'best time':>12}{'iTLB misses':>16}  text mapping")
+    for name, best, output, misses in results:
+        huge_line = next((l.strip() for l in output.splitlines() if l.startswith("AnonHugePages")), "n/a")
+        misses_str = str(misses) if misses is not None else "n/a"
+        print(f"{name:<16}{best:>11.3f}s{misses_str:>16}  {huge_line}")
+    if results[0][2].splitlines()[-1] != results[1][2].splitlines()[-1]:
+        sys.exit("checksums differ between configurations")
+    if not perf:
+        print("\nperf not found: iTLB-load-misses not measured, compare run times instead")
+
+
+if __name__ == "__main__":
+    main()
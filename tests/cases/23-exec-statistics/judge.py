@@ -0,0 +1,71 @@
+#!/usr/bin/env python3
+"""
+统计测试 Judge：验证 FLE_DEBUG=statistics,json 的输出
+- 每个阶段都应出现，且计数合理
+- 主程序的 GOT 重定位应全部在 libcounter.so 中命中
+"""
+import json
+import sys
+import os
+
+PHASES = [
+    "dependency scan",
+    "parse",
+    "mmap",
+    "dynamic relocations",
+    "section relocations",
+    "symbol lookups",
+    "mprotect",
+]
+
+
+def judge():
+    try:
+        input_data = json.load(sys.stdin)
+        build_dir = os.path.join(input_data["test_dir"], "build")
+
+        with open(os.path.join(build_dir, "stats.json"), "r") as f:
+            report = json.load(f)
+
+        phases = {p["name"]: p for p in report.get("phases", [])}
+        missing = [name for name in PHASES if name not in phases]
+        if missing:
+            print(json.dumps({"success": False, "message": f"Missing phases: {missing}"}))
+            return
+
+        modules = {m["name"]: m for m in report.get("modules", [])}
+        lib = modules.get("libcounter.so")
+        if lib is None:
+            print(json.dumps({"success": False, "message": f"libcounter.so not reported: {list(modules)}"}))
+            return
+        if lib["lookup_hits"] < 1:
+            print(json.dumps({"success": False, "message": "Expected lookups to hit libcounter.so"}))
+            return
+
+        dyn_total = sum(m["dyn_relocs"] for m in modules.values())
+        if phases["dynamic relocations"]["count"] != dyn_total:
+            print(json.dumps({"success": False, "message": "Phase count does not match per-module dyn_relocs"}))
+            return
+
+        lookups = phases["symbol lookups"]["count"]
+        hits = sum(m["lookup_hits"] for m in modules.values())
+        if hits != lookups:
+            print(json.dumps({"success": False, "message": f"{lookups} lookups but {hits} hits"}))
+            return
+
+        # 每个模块只做一次 mmap 整体映射（没有二进制段镜像时）
+        if phases["mmap"]["count"] != len(modules):
+            print(json.dumps({"success": False, "message": f"{phases['mmap']['count']} mmap calls for {len(modules)} modules"}))
+            return
+        if not 0 < report.get("vmas_before", 0) < report.get("vmas_after", 0):
+            print(json.dumps({"success": False, "message": "VMA counts before/after loading not reported"}))
+            return
+
+        print(json.dumps({"success": True, "message": f"{len(modules)} modules, {lookups} lookups reported"}))
+
+    except Exception as e:
+        print(json.dumps({"success": False, "message": f"Judge error: {str(e)}"}))
+
+
+if __name__ == "__main__":
+    judge()
@@ -0,0 +1,9 @@
+// 统计测试：共享库中的计数函数
+
+static int counter = 0;
+
+int bump(int x)
+{
+    counter += x;
+    return counter;
+}
@@ -0,0 +1,10 @@
+// 统计测试：主程序通过 PLT/GOT 调用共享库
+
+extern int bump(int);
+
+int main()
+{
+    int a = bump(2); // 2
+    int b = bump(3); // 5
+    return (a == 2 && b == 5) ? 0 : 1;
+}
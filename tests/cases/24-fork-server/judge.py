@@ -0,0 +1,96 @@
+#!/usr/bin/env python3
+"""
+Fork server Judge：通过控制 socket 反复运行同一个预加载的程序
+- 每个请求传入独立的 stdin/stdout，检查输出与退出码
+- 每次运行的全局状态都应是干净的（runs=1）
+"""
+import json
+import os
+import socket
+import struct
+import subprocess
+import sys
+import time
+
+RUNS = 50
+
+
+def recv_exact(sock, size):
+    data = b""
+    while len(data) < size:
+        chunk = sock.recv(size - len(data))
+        if not chunk:
+            raise RuntimeError("fork server closed the control socket")
+        data += chunk
+    return data
+
+
+def run_once(sock, text):
+    in_r, in_w = os.pipe()
+    out_r, out_w = os.pipe()
+    os.write(in_w, text.encode())
+    os.close(in_w)
+    socket.send_fds(sock, [b"R"], [in_r, out_w])
+    os.close(in_r)
+    os.close(out_w)
+    _, status = struct.unpack("ii", recv_exact(sock, 8))
+    with os.fdopen(out_r, "rb") as f:
+        output = f.read().decode()
+    return os.waitstatus_to_exitcode(status), output
+
+
+def judge():
+    try:
+        input_data = json.load(sys.stdin)
+        test_dir = input_data["test_dir"]
+        build_dir = os.path.join(test_dir, "build")
+        root_dir = os.path.abspath(os.path.join(test_dir, "..", "..", ".."))
+        exec_path = os.path.join(root_dir, "exec")
+        program = os.path.join(build_dir, "program")
+        env = dict(os.environ, FLE_LIBRARY_PATH=build_dir)
+
+        server_sock, client_sock = socket.socketpair(socket.AF_UNIX, socket.SOCK_STREAM)
+        server = subprocess.Popen(
+            [exec_path, "--fork-server", str(client_sock.fileno()), program],
+            pass_fds=[client_sock.fileno()],
+            env=env,
+        )
+        client_sock.close()
+
+        try:
+            if recv_exact(server_sock, 4) != b"FLE!":
+                print(json.dumps({"success": False, "message": "Bad fork server hello"}))
+                return
+
+            start = time.monotonic()
+            for i in range(RUNS):
+                text = "x" * (i % 10 + 1)
+                code, output = run_once(server_sock, text)
+                expected = f"runs=1 scaled={len(text) * 3} input={text}"
+                if code != len(text) or output != expected:
+                    print(json.dumps({
+                        "success": False,
+                        "message": f"Run {i}: exit {code}, output {output!r}, expected {expected!r}",
+                    }))
+                    return
+            served = time.monotonic() - start
+        finally:
+            server_sock.close()
+            server.wait(timeout=10)
+
+        start = time.monotonic()
+        for i in range(RUNS):
+            subprocess.run([exec_path, program], input=b"x", env=env, capture_output=True)
+        direct = time.monotonic() - start
+
+        print(json.dumps({
+            "success": True,
+            "message": f"{RUNS} runs: fork server {served:.3f}s, direct exec {direct:.3f}s",
+        }))
+
+    except Exception as e:
+        print(json.dumps({"success": False, "message": f"Judge error: {str(e)}"}))
+
+
+if __name__ == "__main__":
+    judge()
@@ -0,0 +1,6 @@
+// fork server 测试：共享库只在服务启动时加载与重定位一次
+
+int scale(int x)
+{
+    return x * 3;
+}
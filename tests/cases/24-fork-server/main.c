@@ -0,0 +1,22 @@
+// fork server 测试：每次运行都应从干净的初始状态开始
+#include "minilibc.h"
+
+extern int scale(int);
+
+static int runs = 0;
+
+int main()
+{
+    char buf[64];
+    long n = syscall(SYS_read, 0, buf, sizeof(buf) - 1);
+    if (n < 0) {
+        n = 0;
+    }
+    buf[n] = '\0';
+
+    // 如果子进程之间共享了状态，runs 会大于 1
+    runs++;
+    printf("runs=%d scaled=%d input=", runs, scale((int)n));
+    print(buf, NULL);
+    return (int)n;
+}
@@ -0,0 +1,13 @@
+// 快照测试：共享库中的函数，重定位结果需要被完整保存
+
+const char* greet_name(int i)
+{
+    switch (i % 3) {
+    case 0:
+        return "alpha";
+    case 1:
+        return "beta";
+    default:
+        return "gamma";
+    }
+}
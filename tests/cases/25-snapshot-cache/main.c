@@ -0,0 +1,12 @@
+// 快照测试：第二次运行直接映射缓存中已重定位的镜像
+#include "minilibc.h"
+
+extern const char* greet_name(int);
+
+int main()
+{
+    for (int i = 0; i < 3; i++) {
+        print("hello ", greet_name(i), "\n", NULL);
+    }
+    return 0;
+}
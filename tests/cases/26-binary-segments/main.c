@@ -0,0 +1,45 @@
+// 二进制段布局测试：.text 应直接从可执行文件 mmap，而不是匿名内存
+#include "minilibc.h"
+
+static char maps[65536];
+
+static int starts_with(const char* s, const char* prefix)
+{
+    while (*prefix) {
+        if (*s++ != *prefix++)
+            return 0;
+    }
+    return 1;
+}
+
+int main()
+{
+    long fd = syscall(SYS_open, "/proc/self/maps", 0, 0);
+    if (fd < 0) {
+        return 2;
+    }
+    long total = 0, n;
+    while ((n = syscall(SYS_read, fd, maps + total, sizeof(maps) - 1 - total)) > 0) {
+        total += n;
+    }
+    maps[total] = '\0';
+    syscall(SYS_close, fd);
+
+    // 找到 0x400000 处（.text 段）的映射行，检查它是否带有文件名
+    for (char* line = maps; *line;) {
+        char* end = strchr(line, '\n');
+        if (end) {
+            *end = '\0';
+        }
+        if (starts_with(line, "00400000-")) {
+            print(strchr(line, '/') ? "text: file-backed\n" : "text: anonymous\n", NULL);
+            return 0;
+        }
+        if (!end) {
+            break;
+        }
+        line = end + 1;
+    }
+    print("text: not found\n", NULL);
+    return 1;
+}
@@ -0,0 +1,47 @@
+#!/usr/bin/env python3
+"""
+大页布局 Judge：--huge-text 链接出的 .text 段应从 2 MiB 边界开始、长度为 2 MiB 的整数倍，
+其余段都在代码段之后的大页边界以外
+"""
+import json
+import sys
+import os
+
+HUGE_PAGE = 0x200000
+
+
+def check_layout(path):
+    with open(path, "r") as f:
+        content = f.read()
+    if content.startswith("#!"):
+        content = content[content.index("\n") + 1:]
+    obj = json.loads(content)
+    phdrs = {p["name"]: p for p in obj.get("phdrs", [])}
+    text = phdrs.get(".text")
+    if text is None:
+        return f"{os.path.basename(path)}: no .text segment"
+    if text["vaddr"] % HUGE_PAGE or text["size"] % HUGE_PAGE:
+        return f"{os.path.basename(path)}: .text at {text['vaddr']:#x} size {text['size']:#x} is not 2 MiB aligned"
+    text_end = text["vaddr"] + text["size"]
+    for name, p in phdrs.items():
+        if name != ".text" and p["size"] and p["vaddr"] < text_end:
+            return f"{os.path.basename(path)}: {name} at {p['vaddr']:#x} overlaps the padded text"
+    return None
+
+
+def judge():
+    try:
+        input_data = json.load(sys.stdin)
+        build_dir = os.path.join(input_data["test_dir"], "build")
+        for name in ["program", "libhot.so"]:
+            error = check_layout(os.path.join(build_dir, name))
+            if error:
+                print(json.dumps({"success": False, "message": error}))
+                return
+        print(json.dumps({"success": True, "message": "Text segments are 2 MiB aligned and padded"}))
+    except Exception as e:
+        print(json.dumps({"success": False, "message": f"Judge error: {e}"}))
+
+
+if __name__ == "__main__":
+    judge()
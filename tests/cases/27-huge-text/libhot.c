@@ -0,0 +1,5 @@
+// 共享库的代码段同样按 2 MiB 对齐，加载器需要把它放到大页边界上
+int hot_add(int a, int b)
+{
+    return a + b;
+}
@@ -0,0 +1,54 @@
+// 大页代码段测试：--huge-pages 下 .text 应是一整个 2 MiB 匿名映射
+#include "minilibc.h"
+
+extern int hot_add(int a, int b);
+
+static char maps[65536];
+
+static int starts_with(const char* s, const char* prefix)
+{
+    while (*prefix) {
+        if (*s++ != *prefix++)
+            return 0;
+    }
+    return 1;
+}
+
+int main()
+{
+    long fd = syscall(SYS_open, "/proc/self/maps", 0, 0);
+    if (fd < 0) {
+        return 2;
+    }
+    long total = 0, n;
+    while ((n = syscall(SYS_read, fd, maps + total, sizeof(maps) - 1 - total)) > 0) {
+        total += n;
+    }
+    maps[total] = '\0';
+    syscall(SYS_close, fd);
+
+    const char* text = "text: not found\n";
+    for (char* line = maps; *line;) {
+        char* end = strchr(line, '\n');
+        if (end) {
+            *end = '\0';
+        }
+        if (starts_with(line, "00400000-")) {
+            text = starts_with(line, "00400000-00600000 r-xp") && !strchr(line, '/')
+                ? "text: 2 MiB anonymous\n"
+                : "text: regular pages\n";
+            break;
+        }
+        if (!end) {
+            break;
+        }
+        line = end + 1;
+    }
+    print(text, NULL);
+
+    // hot_add 位于库代码段开头附近，库基址按 2 MiB 对齐时其地址的低 21 位很小
+    unsigned long addr = (unsigned long)&hot_add;
+    print((addr & 0x1fffff) < 0x1000 ? "lib: 2 MiB aligned\n" : "lib: unaligned\n", NULL);
+    printf("sum: %d\n", hot_add(40, 2));
+    return 0;
+}
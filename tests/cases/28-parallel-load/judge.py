@@ -0,0 +1,85 @@
+#!/usr/bin/env python3
+"""
+并行加载 Judge：构建 24 个共享库（4 条依赖链），分别用 1 个和 4 个线程运行
+- 两种方式的输出都必须正确
+- 模块顺序（即全局符号查找顺序）必须与深度优先的先序遍历一致：
+  libmod1.so 与 libmod4.so 都定义了 whoami，先序遍历中 libmod4.so 在前
+"""
+import json
+import os
+import subprocess
+import sys
+
+LIBS = 24
+CHAINS = 4
+WHOAMI = {1, 4}
+EXPECTED_OUTPUT = "sum: 276\nwhoami: 4\n"
+
+
+def run(cmd, **kwargs):
+    result = subprocess.run(cmd, capture_output=True, text=True, timeout=30, **kwargs)
+    if result.returncode != 0:
+        raise RuntimeError(f"{' '.join(cmd)} failed: {result.stderr.strip()}")
+    return result
+
+
+def expected_order():
+    order = ["program"]
+    for chain in range(CHAINS):
+        order += [f"libmod{i}.so" for i in range(chain, LIBS, CHAINS)]
+    return order
+
+
+def judge():
+    try:
+        input_data = json.load(sys.stdin)
+        test_dir = input_data["test_dir"]
+        build_dir = os.path.join(test_dir, "build")
+        root_dir = os.path.abspath(os.path.join(test_dir, "..", "..", ".."))
+        cc, ld, exe = (os.path.join(root_dir, tool) for tool in ("cc", "ld", "exec"))
+        common_dir = os.path.join(root_dir, "tests", "common")
+        os.makedirs(build_dir, exist_ok=True)
+
+        # 从链尾开始构建，每个库链接它依赖的下一个库
+        for i in reversed(range(LIBS)):
+            obj = os.path.join(build_dir, f"libmod{i}.o")
+            flags = [f"-DID={i}"]
+            if i + CHAINS < LIBS:
+                flags.append(f"-DNEXT={i + CHAINS}")
+            if i in WHOAMI:
+                flags.append("-DWHOAMI")
+            run([cc, os.path.join(test_dir, "libmod.c"), "-o", obj, "-fPIC", "-Os"] + flags)
+            inputs = [os.path.join(build_dir, f"libmod{i}.fo")]
+            if i + CHAINS < LIBS:
+                inputs.append(os.path.join(build_dir, f"libmod{i + CHAINS}.so"))
+            run([ld, "-shared"] + inputs + ["-o", os.path.join(build_dir, f"libmod{i}.so")])
+
+        run([cc, os.path.join(test_dir, "main.c"), "-o", os.path.join(build_dir, "main.o"),
+             f"-I{common_dir}", "-fPIC", "-Os"])
+        program = os.path.join(build_dir, "program")
+        run([ld, os.path.join(build_dir, "main.fo")]
+            + [os.path.join(build_dir, f"libmod{i}.so") for i in range(CHAINS)]
+            + [os.path.join(common_dir, "minilibc.fo"), "-o", program])
+
+        for jobs in ["1", "4"]:
+            stats_file = os.path.join(build_dir, f"stats-j{jobs}.json")
+            env = dict(os.environ, FLE_LIBRARY_PATH=build_dir,
+                       FLE_DEBUG="statistics,json", FLE_DEBUG_OUTPUT=stats_file)
+            result = run([exe, "--jobs", jobs, program], env=env)
+            if result.stdout != EXPECTED_OUTPUT:
+                print(json.dumps({"success": False,
+                                  "message": f"-j {jobs}: expected {EXPECTED_OUTPUT!r}, got {result.stdout!r}"}))
+                return
+            with open(stats_file, "r") as f:
+                order = [m["name"] for m in json.load(f)["modules"]]
+            if order != expected_order():
+                print(json.dumps({"success": False, "message": f"-j {jobs}: module order {order}"}))
+                return
+
+        print(json.dumps({"success": True, "message": "Output and resolution order match with 1 and 4 threads"}))
+    except Exception as e:
+        print(json.dumps({"success": False, "message": f"Judge error: {str(e)}"}))
+
+
+if __name__ == "__main__":
+    judge()
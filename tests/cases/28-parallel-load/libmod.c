@@ -0,0 +1,25 @@
+// 由 judge.py 以不同的 -DID/-DNEXT 编译成 24 个共享库：
+// libmod<ID>.so 依赖 libmod<NEXT>.so，构成 4 条长度为 6 的依赖链
+#define CAT(a, b) a##b
+#define VALUE(id) CAT(mod_value_, id)
+
+#ifdef NEXT
+extern int VALUE(NEXT)(void);
+#endif
+
+int VALUE(ID)(void)
+{
+#ifdef NEXT
+    return ID + VALUE(NEXT)();
+#else
+    return ID;
+#endif
+}
+
+#ifdef WHOAMI
+// 只有部分库定义 whoami，用来检查全局符号的查找顺序
+int whoami(void)
+{
+    return ID;
+}
+#endif
@@ -0,0 +1,15 @@
+#include "minilibc.h"
+
+extern int mod_value_0(void);
+extern int mod_value_1(void);
+extern int mod_value_2(void);
+extern int mod_value_3(void);
+extern int whoami(void);
+
+int main()
+{
+    int sum = mod_value_0() + mod_value_1() + mod_value_2() + mod_value_3();
+    printf("sum: %d\n", sum);
+    printf("whoami: %d\n", whoami());
+    return 0;
+}
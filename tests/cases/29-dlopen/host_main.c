@@ -0,0 +1,7 @@
+// 主程序只链接 libhost.so，插件由 libhost.so 在运行时加载
+int host_run(void);
+
+int main()
+{
+    return host_run();
+}
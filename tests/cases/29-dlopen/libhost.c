@@ -0,0 +1,17 @@
+// 自带 minilibc 的共享库，在库内部通过 fle_dlopen 加载插件
+#include "minilibc.h"
+
+int host_run(void)
+{
+    void* handle = fle_dlopen("libplugin.so");
+    if (handle == NULL) {
+        print("host dlopen failed: ", fle_dlerror(), "\n", NULL);
+        return 3;
+    }
+    int (*scale)(int) = (int (*)(int))fle_dlsym(handle, "plugin_scale");
+    if (scale == NULL) {
+        return 4;
+    }
+    printf("host scale(2) = %d\n", scale(2));
+    return fle_dlclose(handle);
+}
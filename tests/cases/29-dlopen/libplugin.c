@@ -0,0 +1,15 @@
+// 运行时通过 fle_dlopen 加载的插件，调用主程序中的 printf
+#include "minilibc.h"
+
+static int calls = 0;
+
+int plugin_scale(int x)
+{
+    calls++;
+    return x * 10 + calls;
+}
+
+void plugin_hello(void)
+{
+    printf("plugin loaded, scale(4) = %d\n", plugin_scale(4));
+}
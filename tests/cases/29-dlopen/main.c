@@ -0,0 +1,41 @@
+// fle_dlopen/fle_dlsym/fle_dlclose 测试：插件不在 needed 列表中，只在运行时加载
+#include "minilibc.h"
+
+int main()
+{
+    if (fle_dlopen("libmissing.so") == NULL) {
+        print("missing: ", fle_dlerror(), "\n", NULL);
+    }
+
+    void* handle = fle_dlopen("libplugin.so");
+    if (handle == NULL) {
+        print("dlopen failed: ", fle_dlerror(), "\n", NULL);
+        return 1;
+    }
+
+    void (*hello)(void) = (void (*)(void))fle_dlsym(handle, "plugin_hello");
+    int (*scale)(int) = (int (*)(int))fle_dlsym(handle, "plugin_scale");
+    if (hello == NULL || scale == NULL) {
+        print("dlsym failed: ", fle_dlerror(), "\n", NULL);
+        return 1;
+    }
+    hello();
+    printf("scale(7) = %d\n", scale(7));
+
+    if (fle_dlsym(handle, "plugin_nothing") == NULL) {
+        print("nothing: ", fle_dlerror(), "\n", NULL);
+    }
+    // 句柄为 NULL 时在所有已加载模块中全局查找
+    if (fle_dlsym(NULL, "plugin_scale") == (void*)scale) {
+        print("global lookup ok\n", NULL);
+    }
+
+    // 关闭后重新打开，插件的静态数据重新初始化
+    if (fle_dlclose(handle) != 0) {
+        return 1;
+    }
+    handle = fle_dlopen("libplugin.so");
+    scale = (int (*)(int))fle_dlsym(handle, "plugin_scale");
+    printf("after reopen scale(1) = %d\n", scale(1));
+    return fle_dlclose(handle);
+}
@@ -0,0 +1,5 @@
+// 程序永远不会调用这个库中的函数，运行前它甚至会被删除
+int never_called(int x)
+{
+    return x * 3;
+}
@@ -0,0 +1,8 @@
+// 延迟加载的库：第一次调用 used_sum 时才被映射和重定位
+static int loads = 0;
+
+int used_sum(int a, int b, int c, int d, int e, int f)
+{
+    loads++;
+    return a + b * 2 + c * 3 + d * 4 + e * 5 + f * 6 + loads * 1000;
+}
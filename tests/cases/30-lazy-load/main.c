@@ -0,0 +1,16 @@
+#include "minilibc.h"
+
+extern int used_sum(int a, int b, int c, int d, int e, int f);
+extern int never_called(int x);
+
+int main()
+{
+    print("before first call\n", NULL);
+    // 六个整数参数都经由寄存器传递，延迟绑定不能破坏它们
+    printf("first: %d\n", used_sum(1, 2, 3, 4, 5, 6));
+    printf("second: %d\n", used_sum(6, 5, 4, 3, 2, 1));
+    if (syscall(SYS_getpid) == 0) {
+        return never_called(1);
+    }
+    return 0;
+}
@@ -0,0 +1,36 @@
+// 库内的 IFUNC：解析函数按 CPU 特性挑选实现，每次加载只应调用一次
+static int resolver_calls = 0;
+
+static int has_avx2(void)
+{
+    unsigned a, b, c, d;
+    __asm__ volatile("cpuid" : "=a"(a), "=b"(b), "=c"(c), "=d"(d) : "a"(7), "c"(0));
+    return (b >> 5) & 1;
+}
+
+static int dot3_generic(const int* x, const int* y)
+{
+    return x[0] * y[0] + x[1] * y[1] + x[2] * y[2];
+}
+
+static int dot3_avx2(const int* x, const int* y)
+{
+    int sum = 0;
+    for (int i = 0; i < 3; i++) {
+        sum += x[i] * y[i];
+    }
+    return sum;
+}
+
+static void* resolve_dot3(void)
+{
+    resolver_calls++;
+    return has_avx2() ? (void*)dot3_avx2 : (void*)dot3_generic;
+}
+
+int dot3(const int* x, const int* y) __attribute__((ifunc("resolve_dot3")));
+
+int dot3_resolver_calls(void)
+{
+    return resolver_calls;
+}
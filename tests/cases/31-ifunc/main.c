@@ -0,0 +1,43 @@
+#include "minilibc.h"
+
+extern int dot3(const int* x, const int* y);
+extern int dot3_resolver_calls(void);
+
+// 可执行文件自己的 IFUNC：调用和取址都经过 PLT
+static int scale_resolves = 0;
+
+static int scale_plain(int x)
+{
+    return x * 3;
+}
+
+static int scale_shift(int x)
+{
+    return (x << 1) + x;
+}
+
+static void* resolve_scale(void)
+{
+    unsigned a, b, c, d;
+    __asm__ volatile("cpuid" : "=a"(a), "=b"(b), "=c"(c), "=d"(d) : "a"(1));
+    scale_resolves++;
+    return (d >> 26) & 1 ? (void*)scale_shift : (void*)scale_plain;
+}
+
+int scale(int x) __attribute__((ifunc("resolve_scale")));
+
+int main()
+{
+    int x[3] = { 1, 2, 3 };
+    int y[3] = { 4, 5, 6 };
+    int total = 0;
+    for (int i = 0; i < 4; i++) {
+        total += dot3(x, y) + scale(i);
+    }
+    int (*volatile fp)(int) = scale;
+    printf("dot3: %d\n", dot3(x, y));
+    printf("total: %d\n", total);
+    printf("pointer: %d\n", fp(7));
+    printf("resolver calls: %d %d\n", dot3_resolver_calls(), scale_resolves);
+    return 0;
+}
@@ -0,0 +1,13 @@
+// 线程局部计数器：定义在另一个目标文件中，main.c 通过 initial-exec 模型访问
+__thread int hits = 100;
+__thread long misses;
+__thread char tag[8] = "tls";
+
+void record(int hit)
+{
+    if (hit) {
+        hits++;
+    } else {
+        misses++;
+    }
+}
@@ -0,0 +1,44 @@
+#include "minilibc.h"
+
+extern __thread int hits;
+extern __thread long misses;
+extern __thread char tag[8];
+extern void record(int hit);
+
+// 本文件内的 TLS 变量走 local-exec 模型（%fs 相对偏移在链接时确定）
+static __thread int local_calls = 7;
+__thread int zeroed[16];
+
+static int* slot(int i)
+{
+    return &zeroed[i];
+}
+
+int main()
+{
+    for (int i = 0; i < 10; i++) {
+        record(i % 3 != 0);
+        local_calls++;
+        *slot(i) += i;
+    }
+    int sum = 0;
+    for (int i = 0; i < 16; i++) {
+        sum += zeroed[i];
+    }
+    long fs_self;
+    __asm__ volatile("mov %%fs:0, %0" : "=r"(fs_self));
+    int in_block = (unsigned long)&hits < (unsigned long)fs_self && (unsigned long)&zeroed[15] < (unsigned long)fs_self;
+
+    printf("hits: %d\n", hits);
+    printf("misses: %d\n", (int)misses);
+    printf("local calls: %d\n", local_calls);
+    printf("zeroed sum: %d\n", sum);
+    print(tag, NULL);
+    print("\n", NULL);
+    printf("below thread pointer: %d\n", in_block);
+    // 回调加载器时要切回宿主的 %fs，返回后 TLS 仍然可用
+    printf("dlsym: %d\n", fle_dlsym(NULL, "record") != NULL);
+    hits += 1000;
+    printf("hits after callback: %d\n", hits);
+    return 0;
+}
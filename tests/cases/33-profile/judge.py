@@ -0,0 +1,67 @@
+#!/usr/bin/env python3
+"""
+采样分析 Judge：用 exec --profile 运行程序
+- 程序输出与退出码不受影响（退出码 3 由父进程原样传回）
+- profile.json 的样本数与 profile.folded 中的计数一致
+- spin 的自身样本最多；hot_path 的总样本多于 cold_path
+- 折叠栈中能看到 main;hot_path;spin 这条调用链
+"""
+import json
+import os
+import subprocess
+import sys
+
+
+def judge():
+    try:
+        input_data = json.load(sys.stdin)
+        test_dir = input_data["test_dir"]
+        build_dir = os.path.join(test_dir, "build")
+        root_dir = os.path.abspath(os.path.join(test_dir, "..", "..", ".."))
+        profile = os.path.join(build_dir, "profile.json")
+        folded = os.path.join(build_dir, "profile.folded")
+        for path in (profile, folded):
+            if os.path.exists(path):
+                os.remove(path)
+
+        result = subprocess.run([os.path.join(root_dir, "exec"), f"--profile={profile}",
+                                 os.path.join(build_dir, "program")],
+                                capture_output=True, text=True, timeout=50)
+        if result.returncode != 3 or result.stdout != "done\n":
+            print(json.dumps({"success": False,
+                              "message": f"exit {result.returncode}, stdout {result.stdout!r}, stderr {result.stderr.strip()!r}"}))
+            return
+
+        with open(profile, "r") as f:
+            report = json.load(f)
+        functions = {entry["name"]: entry for entry in report["functions"]}
+        if report["samples"] < 10:
+            print(json.dumps({"success": False, "message": f"only {report['samples']} samples"}))
+            return
+
+        stacks = {}
+        with open(folded, "r") as f:
+            for line in f:
+                stack, count = line.rsplit(" ", 1)
+                stacks[stack] = int(count)
+        if sum(stacks.values()) != report["samples"]:
+            print(json.dumps({"success": False, "message": "collapsed stack counts do not add up to the sample count"}))
+            return
+
+        top = report["functions"][0]["name"]
+        hot = functions.get("hot_path", {}).get("total", 0)
+        cold = functions.get("cold_path", {}).get("total", 0)
+        if top != "spin" or hot <= cold:
+            print(json.dumps({"success": False, "message": f"top {top}, hot_path {hot}, cold_path {cold}"}))
+            return
+        if not any(stack.endswith("main;hot_path;spin") for stack in stacks):
+            print(json.dumps({"success": False, "message": f"no main;hot_path;spin stack in {list(stacks)}"}))
+            return
+
+        print(json.dumps({"success": True, "message": f"{report['samples']} samples, spin on top"}))
+    except Exception as e:
+        print(json.dumps({"success": False, "message": f"Judge error: {str(e)}"}))
+
+
+if __name__ == "__main__":
+    judge()
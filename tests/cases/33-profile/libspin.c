@@ -0,0 +1,9 @@
+// 运行时通过 fle_dlopen 加载的插件，采样热点都在这里
+__attribute__((noinline)) long plugin_spin(long n)
+{
+    long s = 0;
+    for (long i = 0; i < n; i++) {
+        s += i * i ^ (s >> 3);
+    }
+    return s;
+}
@@ -0,0 +1,33 @@
+#include "minilibc.h"
+
+// 用 -fno-omit-frame-pointer -mno-omit-leaf-frame-pointer 编译，采样时可以沿帧指针回溯完整调用栈
+static volatile long sink;
+
+__attribute__((noinline)) long spin(long n)
+{
+    long s = 0;
+    for (long i = 0; i < n; i++) {
+        s += i * i ^ (s >> 3);
+    }
+    return s;
+}
+
+__attribute__((noinline)) long hot_path(long n)
+{
+    return spin(n * 4) + 1;
+}
+
+__attribute__((noinline)) long cold_path(long n)
+{
+    return spin(n) + 1;
+}
+
+int main()
+{
+    for (int k = 0; k < 40; k++) {
+        sink = hot_path(1000000 + k);
+        sink = cold_path(1000000 + k);
+    }
+    print("done\n", NULL);
+    return 3;
+}
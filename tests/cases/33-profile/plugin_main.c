@@ -0,0 +1,18 @@
+// 热点函数在启动后才加载的插件中：采样结果要能还原出插件中的函数名
+#include "minilibc.h"
+
+static volatile long sink;
+
+int main()
+{
+    void* handle = fle_dlopen("libspin.so");
+    if (handle == NULL) {
+        print("dlopen failed: ", fle_dlerror(), "\n", NULL);
+        return 1;
+    }
+    long (*spin)(long) = (long (*)(long))fle_dlsym(handle, "plugin_spin");
+    for (int k = 0; k < 40; k++) {
+        sink = spin(4000000 + k);
+    }
+    return 0;
+}
@@ -0,0 +1,53 @@
+#!/usr/bin/env python3
+"""
+PLT 调用计数测试 Judge：运行 exec --count-plt
+- 程序的输出和退出码不受影响
+- 每个导入函数的调用次数准确，延迟绑定之后的调用也被计数
+"""
+import json
+import os
+import re
+import subprocess
+import sys
+
+EXPECTED = {"add": 100, "scale": 5, "ping": 3, "unused": 0}
+
+
+def result(success, message):
+    print(json.dumps({"success": success, "message": message}))
+
+
+def judge():
+    input_data = json.load(sys.stdin)
+    test_dir = input_data["test_dir"]
+    build_dir = os.path.join(test_dir, "build")
+    root_dir = os.path.abspath(os.path.join(test_dir, "..", "..", ".."))
+
+    env = dict(os.environ, FLE_LIBRARY_PATH=build_dir)
+    proc = subprocess.run(
+        [os.path.join(root_dir, "exec"), "--count-plt", os.path.join(build_dir, "program")],
+        capture_output=True,
+        text=True,
+        env=env,
+        timeout=30,
+    )
+    if proc.returncode != 0:
+        return result(False, f"exec exited with {proc.returncode}: {proc.stderr}")
+    if not proc.stdout.startswith("sum: "):
+        return result(False, f"Unexpected program output: {proc.stdout!r}")
+
+    counts = {}
+    for line in proc.stderr.splitlines():
+        m = re.match(r"^\s+(\d+)\s+(\S.*)$", line)
+        if m:
+            counts[m.group(2)] = int(m.group(1))
+    for symbol, calls in EXPECTED.items():
+        if counts.get(symbol) != calls:
+            return result(False, f"Expected {calls} calls to {symbol}, got {counts.get(symbol)}: {proc.stderr}")
+    if counts.get("(total)") != sum(EXPECTED.values()):
+        return result(False, f"Total does not match: {proc.stderr}")
+    result(True, "PLT call counts are exact")
+
+
+if __name__ == "__main__":
+    judge()
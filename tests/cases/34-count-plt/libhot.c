@@ -0,0 +1,15 @@
+// 启动时加载的库：add 在循环中被频繁调用，scale 只调用几次
+int add(int a, int b)
+{
+    return a + b;
+}
+
+int scale(int x)
+{
+    return x * 3;
+}
+
+int unused(int x)
+{
+    return x - 1;
+}
@@ -0,0 +1,5 @@
+// 延迟加载的库：绑定之后的调用也要继续计数
+int ping(int x)
+{
+    return x + 7;
+}
@@ -0,0 +1,23 @@
+#include "minilibc.h"
+
+extern int add(int a, int b);
+extern int scale(int x);
+extern int unused(int x);
+extern int ping(int x);
+
+int main()
+{
+    int sum = 0;
+    for (int i = 0; i < 100; i++) {
+        sum = add(sum, i);
+    }
+    for (int i = 0; i < 5; i++) {
+        sum = scale(sum) % 1000;
+    }
+    sum += ping(1) + ping(2) + ping(3);
+    if (syscall(SYS_getpid) == 0) {
+        sum = unused(sum);
+    }
+    printf("sum: %d\n", sum);
+    return 0;
+}
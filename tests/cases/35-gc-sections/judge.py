@@ -0,0 +1,47 @@
+#!/usr/bin/env python3
+"""
+节回收测试 Judge：检查 --print-gc-sections 的报告与输出文件
+- 不可达的函数、数据及只被它们引用的静态函数被移除
+- 从 main 可达的节全部保留，输出文件比不回收时更小
+"""
+import json
+import os
+import re
+
+REMOVED = [".text.unused_fn", ".text.dead_helper", ".data.unused_table", ".rodata.unused_message"]
+KEPT = [".text.used", ".text.scale", ".data.counter", ".text.main"]
+
+
+def result(success, message):
+    print(json.dumps({"success": success, "message": message}))
+
+
+def segment_sizes(path):
+    with open(path) as f:
+        return {ph["name"]: ph["size"] for ph in json.load(f)["phdrs"]}
+
+
+def judge():
+    input_data = json.load(__import__("sys").stdin)
+    build_dir = os.path.join(input_data["test_dir"], "build")
+    removed = set(re.findall(r"^removing unused section \S+:\((\S+)\)$", input_data["stderr"], re.MULTILINE))
+
+    missing = [name for name in REMOVED if name not in removed]
+    if missing:
+        return result(False, f"Expected these sections to be removed: {missing}")
+    wrong = [name for name in KEPT if name in removed]
+    if wrong:
+        return result(False, f"Reachable sections were removed: {wrong}")
+
+    full = segment_sizes(os.path.join(build_dir, "program_full"))
+    gc = segment_sizes(os.path.join(build_dir, "program"))
+    for seg in (".text", ".rodata", ".data"):
+        if gc.get(seg, 0) > full.get(seg, 0):
+            return result(False, f"{seg} grew with --gc-sections: {full.get(seg)} -> {gc.get(seg)}")
+    if gc[".data"] + 1024 > full[".data"]:
+        return result(False, f"unused_table was not dropped from .data: {full['.data']} -> {gc['.data']}")
+    result(True, f"Removed {len(removed)} unused sections")
+
+
+if __name__ == "__main__":
+    judge()
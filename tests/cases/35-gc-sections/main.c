@@ -0,0 +1,11 @@
+#include "minilibc.h"
+
+extern int used(int x);
+extern int counter;
+
+int main()
+{
+    counter += used(4);
+    printf("counter: %d\n", counter);
+    return 0;
+}
@@ -0,0 +1,26 @@
+// 每个函数和变量各自成节（-ffunction-sections -fdata-sections），
+// 只有从 main 可达的节应当保留
+__attribute__((noinline)) static int scale(int x)
+{
+    return x * 3;
+}
+
+int used(int x)
+{
+    return scale(x) + 1;
+}
+
+// 只被不可达函数引用的静态函数同样应被回收
+__attribute__((noinline)) static int dead_helper(int x)
+{
+    return x ^ 0x5a;
+}
+
+int unused_fn(int x)
+{
+    return dead_helper(x) - 5;
+}
+
+int counter = 40;
+int unused_table[256] = { 1, 2, 3 };
+const char unused_message[] = "this string is never referenced";
@@ -0,0 +1,55 @@
+#!/usr/bin/env python3
+"""
+ICF 测试 Judge：比较不折叠、--icf=all、--icf=safe 三个输出
+- 相同的函数（包括要迭代才能判定相同的调用者）共用同一地址
+- 内容不同的函数不折叠；safe 模式不折叠地址被使用的函数
+- 折叠后 .text 变小
+"""
+import json
+import os
+import sys
+
+
+def result(success, message):
+    print(json.dumps({"success": success, "message": message}))
+
+
+def load(path):
+    with open(path) as f:
+        fle = json.load(f)
+    text = next(ph["size"] for ph in fle["phdrs"] if ph["name"] == ".text")
+    addrs = {}
+    for line in fle.get(".text", []):
+        if line.startswith("📤: "):
+            name, _, offset = line[len("📤: "):].split()
+            addrs[name] = int(offset)
+    for sym in fle.get("symbols", []):
+        addrs.setdefault(sym["name"], sym.get("offset"))
+    return text, addrs
+
+
+def judge():
+    build_dir = os.path.join(json.load(sys.stdin)["test_dir"], "build")
+    full_text, full = load(os.path.join(build_dir, "program_full"))
+    all_text, folded_all = load(os.path.join(build_dir, "program_all"))
+    safe_text, folded_safe = load(os.path.join(build_dir, "program"))
+
+    if full["add_one_a"] == full["add_one_b"]:
+        return result(False, "Functions were folded without --icf")
+    for name, addrs in (("all", folded_all), ("safe", folded_safe)):
+        for a, b in (("add_one_a", "add_one_b"), ("twice_a", "twice_b")):
+            if addrs[a] != addrs[b]:
+                return result(False, f"--icf={name} did not fold {a} and {b}")
+        if addrs["add_two"] == addrs["add_one_a"]:
+            return result(False, f"--icf={name} folded add_two, which differs")
+    if folded_all["pick_a"] != folded_all["pick_b"]:
+        return result(False, "--icf=all did not fold pick_a and pick_b")
+    if folded_safe["pick_a"] == folded_safe["pick_b"]:
+        return result(False, "--icf=safe folded address-taken pick_a and pick_b")
+    if not (all_text < safe_text < full_text):
+        return result(False, f"Unexpected .text sizes: full {full_text}, safe {safe_text}, all {all_text}")
+    result(True, f".text: {full_text} -> {safe_text} (safe), {all_text} (all)")
+
+
+if __name__ == "__main__":
+    judge()
@@ -0,0 +1,19 @@
+#include "minilibc.h"
+
+extern int twice_a(int x);
+extern int twice_b(int x);
+extern int add_two(int x);
+
+typedef int (*op_t)(int);
+extern op_t pick(int i);
+
+int main()
+{
+    // 取地址的函数在 --icf=safe 下必须保持不同的地址
+    op_t ops[2] = { pick(0), pick(1) };
+    printf("twice: %d %d\n", twice_a(3), twice_b(3));
+    printf("add_two: %d\n", add_two(3));
+    printf("pick: %d %d\n", ops[0](10), ops[1](10));
+    printf("distinct: %d\n", ops[0] != ops[1]);
+    return 0;
+}
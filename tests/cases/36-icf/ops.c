@@ -0,0 +1,46 @@
+// 每个函数单独成节。*_a 与 *_b 的机器码完全相同：
+// add_one_* 可以直接折叠，twice_* 分别调用 add_one_a/add_one_b，
+// 要在 add_one_* 折叠之后才能判定相同；pick_* 的地址被使用
+__attribute__((noinline)) int add_one_a(int x)
+{
+    return x * 7 + 1;
+}
+
+__attribute__((noinline)) int add_one_b(int x)
+{
+    return x * 7 + 1;
+}
+
+__attribute__((noinline)) int twice_a(int x)
+{
+    return add_one_a(add_one_a(x)) ^ 0x55;
+}
+
+__attribute__((noinline)) int twice_b(int x)
+{
+    return add_one_b(add_one_b(x)) ^ 0x55;
+}
+
+// 与 add_one_* 只差一个常量，不能折叠
+__attribute__((noinline)) int add_two(int x)
+{
+    return x * 7 + 2;
+}
+
+int pick_a(int x)
+{
+    return x - 3;
+}
+
+int pick_b(int x)
+{
+    return x - 3;
+}
+
+// 以 rip 相对的 lea 取得 pick_* 的地址
+typedef int (*op_t)(int);
+
+op_t pick(int i)
+{
+    return i ? pick_b : pick_a;
+}
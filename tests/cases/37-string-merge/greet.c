@@ -0,0 +1,16 @@
+#include "minilibc.h"
+
+// 与 main.c 中相同的字面量只应保留一份
+void greet(const char* who)
+{
+    print("hello, ", NULL);
+    print(who, NULL);
+    print("\n", NULL);
+    print("shared literal across objects\n", NULL);
+}
+
+// "world\n" 是 main.c 中 "brave new world\n" 的后缀，可以尾部合并
+const char* world(void)
+{
+    return "world\n";
+}
@@ -0,0 +1,46 @@
+#!/usr/bin/env python3
+"""
+字符串合并测试 Judge：检查输出文件的 .rodata
+- cc 为字符串节记录 MERGE|STRINGS 标志和项大小
+- 两个目标文件中相同的字符串只出现一次，后缀字符串不单独存放
+"""
+import json
+import os
+import sys
+
+FLAG_MERGE = 32
+FLAG_STRINGS = 64
+
+
+def result(success, message):
+    print(json.dumps({"success": success, "message": message}))
+
+
+def section_bytes(fle, name):
+    data = bytearray()
+    for line in fle.get(name, []):
+        if line.startswith("🔢: "):
+            data += bytes(int(b, 16) for b in line[len("🔢: "):].split())
+    return bytes(data)
+
+
+def judge():
+    build_dir = os.path.join(json.load(sys.stdin)["test_dir"], "build")
+    with open(os.path.join(build_dir, "greet.fo")) as f:
+        greet = json.load(f)
+    strs = [h for h in greet["shdrs"] if h["name"].startswith(".rodata.str")]
+    if not strs or not all(h["flags"] & FLAG_MERGE and h["flags"] & FLAG_STRINGS and h.get("entsize") == 1 for h in strs):
+        return result(False, f"String sections lack MERGE|STRINGS/entsize: {strs}")
+
+    with open(os.path.join(build_dir, "program")) as f:
+        rodata = section_bytes(json.load(f), ".rodata")
+    for literal in (b"shared literal across objects\n\0", b"hello, \0"):
+        if rodata.count(literal) != 1:
+            return result(False, f"{literal!r} appears {rodata.count(literal)} times in .rodata")
+    if rodata.count(b"world\n\0") != 1:
+        return result(False, "world\\n was not tail-merged into brave new world\\n")
+    result(True, f".rodata is {len(rodata)} bytes")
+
+
+if __name__ == "__main__":
+    judge()
@@ -0,0 +1,18 @@
+#include "minilibc.h"
+
+extern void greet(const char* who);
+extern const char* world(void);
+
+int main()
+{
+    greet("linker");
+    print("shared literal across objects\n", NULL);
+    print("brave new world\n", NULL);
+    print(world(), NULL);
+    // 指向字符串中间：以节符号加偏移的形式引用
+    const char* tail = "0123456789\n" + 6;
+    print(tail, NULL);
+    print("hello, ", NULL);
+    print("merged\n", NULL);
+    return 0;
+}
@@ -0,0 +1,55 @@
+#!/usr/bin/env python3
+"""
+常量合并测试 Judge：检查输出文件的 .rodata
+- cc 为 .rodata.cst8/.rodata.cst16 记录 MERGE 标志和项大小
+- 两个目标文件共有的 double 常量与向量掩码只出现一次，且按项大小对齐
+"""
+import json
+import os
+import struct
+import sys
+
+FLAG_MERGE = 32
+
+
+def result(success, message):
+    print(json.dumps({"success": success, "message": message}))
+
+
+def section_bytes(fle, name):
+    data = bytearray()
+    for line in fle.get(name, []):
+        if line.startswith("🔢: "):
+            data += bytes(int(b, 16) for b in line[len("🔢: "):].split())
+    return bytes(data)
+
+
+def judge():
+    build_dir = os.path.join(json.load(sys.stdin)["test_dir"], "build")
+    with open(os.path.join(build_dir, "mathA.fo")) as f:
+        shdrs = {h["name"]: h for h in json.load(f)["shdrs"]}
+    for name, entsize in ((".rodata.cst8", 8), (".rodata.cst16", 16)):
+        h = shdrs.get(name)
+        if h is None or not h["flags"] & FLAG_MERGE or h.get("entsize") != entsize:
+            return result(False, f"{name} lacks MERGE/entsize {entsize}: {h}")
+
+    with open(os.path.join(build_dir, "program")) as f:
+        fle = json.load(f)
+    rodata = section_bytes(fle, ".rodata")
+    base = next(ph["vaddr"] for ph in fle["phdrs"] if ph["name"] == ".rodata")
+    constants = {
+        "2.5": (struct.pack("<d", 2.5), 8),
+        "0.75": (struct.pack("<d", 0.75), 8),
+        "mask": (struct.pack("<4I", 0x0F0F0F0F, 0x00FF00FF, 0x7FFFFFFF, 0x12345678), 16),
+    }
+    for name, (blob, align) in constants.items():
+        count = rodata.count(blob)
+        if count != 1:
+            return result(False, f"Constant {name} appears {count} times in .rodata")
+        if (base + rodata.find(blob)) % align != 0:
+            return result(False, f"Constant {name} is not {align}-byte aligned")
+    result(True, f".rodata is {len(rodata)} bytes")
+
+
+if __name__ == "__main__":
+    judge()
@@ -0,0 +1,13 @@
+#include "minilibc.h"
+
+extern int scale_a(int x);
+extern int scale_b(int x);
+extern int mask_a(int x);
+extern int mask_b(int x);
+
+int main()
+{
+    printf("scale: %d %d\n", scale_a(10), scale_b(10));
+    printf("mask: %d %d\n", mask_a(100), mask_b(100));
+    return 0;
+}
@@ -0,0 +1,15 @@
+// 浮点常量与 16 字节的向量掩码由编译器放在 .rodata.cst8/.rodata.cst16 中
+typedef int v4si __attribute__((vector_size(16)));
+
+int scale_a(int x)
+{
+    return (int)(x * 2.5 + 0.75);
+}
+
+int mask_a(int x)
+{
+    v4si v = { x, x + 1, x + 2, x + 3 };
+    v4si m = { 0x0f0f0f0f, 0x00ff00ff, 0x7fffffff, 0x12345678 };
+    v4si r = v & m;
+    return r[0] + r[1] + r[2] + r[3];
+}
@@ -0,0 +1,15 @@
+// 与 mathA.c 使用相同的常量：链接后每个常量只应保留一份
+typedef int v4si __attribute__((vector_size(16)));
+
+int scale_b(int x)
+{
+    return (int)(x * 2.5 - 0.75);
+}
+
+int mask_b(int x)
+{
+    v4si v = { x * 2, x * 3, x * 4, x * 5 };
+    v4si m = { 0x0f0f0f0f, 0x00ff00ff, 0x7fffffff, 0x12345678 };
+    v4si r = v & m;
+    return r[0] ^ r[1] ^ r[2] ^ r[3];
+}
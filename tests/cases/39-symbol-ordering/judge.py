@@ -0,0 +1,60 @@
+#!/usr/bin/env python3
+"""
+符号排序测试 Judge：检查 profile.order 与重排后的代码段
+- 采样得到的顺序以 mix 开头，hot_loop 紧随其后的几项之内
+- 重排后 mix、hot_loop 位于 .text 最前面，冷函数 checksum、clamp、setup、report 在它们之后
+- 不重排时 mix 不在 .text 开头（说明顺序确实被改变了）
+"""
+import json
+import os
+import subprocess
+import sys
+
+HOT = ["mix", "hot_loop"]
+COLD = ["checksum", "clamp", "setup", "report"]
+
+
+def result(success, message):
+    print(json.dumps({"success": success, "message": message}))
+
+
+def text_symbols(root_dir, path):
+    out = subprocess.run([os.path.join(root_dir, "nm"), path], capture_output=True, text=True).stdout
+    symbols = {}
+    for line in out.splitlines():
+        parts = line.split()
+        if len(parts) == 3 and parts[1] in "Tt":
+            symbols[parts[2]] = int(parts[0], 16)
+    return symbols
+
+
+def judge():
+    input_data = json.load(sys.stdin)
+    test_dir = input_data["test_dir"]
+    build_dir = os.path.join(test_dir, "build")
+    root_dir = os.path.abspath(os.path.join(test_dir, "..", "..", ".."))
+
+    with open(os.path.join(build_dir, "profile.order")) as f:
+        order = [line.strip() for line in f if line.strip() and not line.startswith("#")]
+    if order[:1] != ["mix"] or "hot_loop" not in order[:3]:
+        return result(False, f"Unexpected profile order: {order}")
+
+    plain = text_symbols(root_dir, os.path.join(build_dir, "program_plain"))
+    ordered = text_symbols(root_dir, os.path.join(build_dir, "program"))
+    if plain.get("mix") == 0:
+        return result(False, "mix is already first without an ordering file")
+    if ordered.get("mix") != 0:
+        return result(False, f"mix is not at the start of .text: {ordered.get('mix')}")
+    hot_end = ordered["hot_loop"]
+    if hot_end <= ordered["mix"]:
+        return result(False, "hot_loop is placed before mix")
+    early = [name for name in COLD if ordered.get(name, -1) < hot_end]
+    if early:
+        return result(False, f"Cold functions placed among the hot ones: {early}")
+    if "warning" in input_data["stderr"]:
+        return result(False, f"Unexpected warnings: {input_data['stderr'].strip()}")
+    result(True, f"Hot functions first: {order[:2]}")
+
+
+if __name__ == "__main__":
+    judge()
@@ -0,0 +1,38 @@
+#include "minilibc.h"
+
+// 用 -ffunction-sections -fno-omit-frame-pointer 编译：每个函数单独成节，采样时可以回溯调用栈
+extern long checksum(const char* s);
+extern long mix(long a, long b);
+extern long clamp(long v, long lo, long hi);
+
+static volatile long sink;
+
+__attribute__((noinline)) long setup(void)
+{
+    return checksum("symbol ordering") & 0xff;
+}
+
+__attribute__((noinline)) long hot_loop(long n, long seed)
+{
+    long s = seed;
+    for (long i = 0; i < n; i++) {
+        s = mix(s, i);
+    }
+    return s;
+}
+
+__attribute__((noinline)) long report(long v)
+{
+    return clamp(v, 0, 100);
+}
+
+int main()
+{
+    long seed = setup();
+    for (int k = 0; k < 40; k++) {
+        sink = hot_loop(4000000, seed + k);
+    }
+    printf("seed: %d\n", (int)seed);
+    printf("report: %d\n", (int)report(seed));
+    return 0;
+}
@@ -0,0 +1,17 @@
+// 冷热函数交错排列：不调整顺序时，热点函数之间隔着从不执行的代码
+__attribute__((noinline)) long checksum(const char* s)
+{
+    long h = 0;
+    while (*s) h = h * 31 + *s++;
+    return h;
+}
+
+__attribute__((noinline)) long mix(long a, long b)
+{
+    return (a * 2654435761L) ^ (b >> 7) ^ (a << 3);
+}
+
+__attribute__((noinline)) long clamp(long v, long lo, long hi)
+{
+    return v < lo ? lo : v > hi ? hi : v;
+}
@@ -0,0 +1,62 @@
+#!/usr/bin/env python3
+"""
+调用图排序测试 Judge：检查 ld 的报告与重排后的代码段
+- 报告的估计页数在重排后减少
+- 不带采样数据时，调用图中的函数（main、step、leaf_a、leaf_b、report、format_value）都排在冷函数 pad_* 之前
+- 带 --call-graph-profile 时，采样到的调用链 main -> step -> leaf_a/leaf_b 落在代码段的第一页内
+"""
+import json
+import os
+import re
+import subprocess
+import sys
+
+PADS = ["pad_1", "pad_2", "pad_3", "pad_4"]
+
+
+def result(success, message):
+    print(json.dumps({"success": success, "message": message}))
+
+
+def text_symbols(root_dir, path):
+    out = subprocess.run([os.path.join(root_dir, "nm"), path], capture_output=True, text=True).stdout
+    symbols = {}
+    for line in out.splitlines():
+        parts = line.split()
+        if len(parts) == 3 and parts[1] in "Tt":
+            symbols[parts[2]] = int(parts[0], 16)
+    return symbols
+
+
+def judge():
+    input_data = json.load(sys.stdin)
+    test_dir = input_data["test_dir"]
+    build_dir = os.path.join(test_dir, "build")
+    root_dir = os.path.abspath(os.path.join(test_dir, "..", "..", ".."))
+
+    match = re.search(r"^call graph sort: (\d+) sections in (\d+) clusters, estimated pages touched: (\d+) -> (\d+)$",
+                      input_data["stderr"], re.MULTILINE)
+    if not match:
+        return result(False, f"No call graph sort report in stderr: {input_data['stderr'].strip()!r}")
+    before, after = int(match.group(3)), int(match.group(4))
+    if after >= before:
+        return result(False, f"Pages touched did not decrease: {before} -> {after}")
+
+    profiled = os.path.exists(os.path.join(build_dir, "program_profile"))
+    symbols = text_symbols(root_dir, os.path.join(build_dir, "program_profile" if profiled else "program"))
+    first_pad = min(symbols[name] for name in PADS)
+    if profiled:
+        hot = ["main", "step", "leaf_a", "leaf_b"]
+        outside = [name for name in hot if symbols[name] >= 4096]
+        if outside:
+            return result(False, f"Sampled functions outside the first page: {outside}")
+    else:
+        hot = ["main", "step", "leaf_a", "leaf_b", "report", "format_value"]
+    late = [name for name in hot if symbols[name] > first_pad]
+    if late:
+        return result(False, f"Functions placed after the cold padding: {late}")
+    result(True, f"Pages touched {before} -> {after}")
+
+
+if __name__ == "__main__":
+    judge()
@@ -0,0 +1,54 @@
+#include "minilibc.h"
+
+// 用 -ffunction-sections -fno-omit-frame-pointer 编译。热点函数之间夹着约 3 KB 的冷函数，
+// 按输入顺序排列时调用链 main -> step -> leaf_a/leaf_b 横跨好几页
+#define COLD(name) \
+    __attribute__((noinline)) void name(void) { __asm__ volatile(".skip 3000, 0x90"); }
+
+static volatile long sink;
+
+long leaf_b(long x);
+
+__attribute__((noinline)) long leaf_a(long x)
+{
+    return x * 3 + 1;
+}
+
+COLD(pad_1)
+
+__attribute__((noinline)) long step(long x)
+{
+    return leaf_a(x) ^ leaf_b(x >> 1);
+}
+
+COLD(pad_2)
+
+__attribute__((noinline)) long leaf_b(long x)
+{
+    return x ^ (x << 5);
+}
+
+COLD(pad_3)
+
+__attribute__((noinline)) int format_value(long v)
+{
+    return (int)(v & 0xffff);
+}
+
+COLD(pad_4)
+
+__attribute__((noinline)) void report(long v)
+{
+    printf("value: %d\n", format_value(v));
+}
+
+int main()
+{
+    long v = 7;
+    for (long i = 0; i < 40000000; i++) {
+        v = step(v + i);
+    }
+    sink = v;
+    report(step(42));
+    return 0;
+}
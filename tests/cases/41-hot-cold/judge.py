@@ -0,0 +1,62 @@
+#!/usr/bin/env python3
+"""
+冷热分组测试 Judge：用 nm 检查两种顺序下各组的位置
+- 默认顺序：fast_path(.text.hot) < helper(.text) < main(.text.startup) < fail(.text.unlikely)，
+  counter(.data) 排在 names(.data.rel.ro) 之后
+- 反转顺序：fail < main < helper < fast_path，counter 位于 .data 开头
+- 每组的第一个函数从 64 字节边界开始
+"""
+import json
+import os
+import subprocess
+import sys
+
+DEFAULT = ["fast_path", "helper", "main", "fail"]
+
+
+def result(success, message):
+    print(json.dumps({"success": success, "message": message}))
+
+
+def symbols(root_dir, path):
+    out = subprocess.run([os.path.join(root_dir, "nm"), path], capture_output=True, text=True).stdout
+    table = {}
+    for line in out.splitlines():
+        parts = line.split()
+        if len(parts) == 3:
+            table[parts[2]] = (parts[1], int(parts[0], 16))
+    return table
+
+
+def check(table, order, relro_first):
+    addrs = [table[name][1] for name in order]
+    if addrs != sorted(addrs):
+        return f"functions not in group order {order}: {[hex(a) for a in addrs]}"
+    unaligned = [name for name in order if table[name][1] % 64]
+    if unaligned:
+        return f"group starts not 64-byte aligned: {unaligned}"
+    counter = table["counter"][1]
+    if relro_first and counter < 0x18:
+        return f"counter at {counter:#x} precedes the .data.rel.ro table"
+    if not relro_first and counter != 0:
+        return f"counter at {counter:#x} is not at the start of .data"
+    return None
+
+
+def judge():
+    input_data = json.load(sys.stdin)
+    test_dir = input_data["test_dir"]
+    build_dir = os.path.join(test_dir, "build")
+    root_dir = os.path.abspath(os.path.join(test_dir, "..", "..", ".."))
+
+    error = check(symbols(root_dir, os.path.join(build_dir, "program")), DEFAULT, True)
+    if error:
+        return result(False, f"default order: {error}")
+    error = check(symbols(root_dir, os.path.join(build_dir, "program_rev")), DEFAULT[::-1], False)
+    if error:
+        return result(False, f"reversed order: {error}")
+    result(True, "Text and data groups laid out in the requested order")
+
+
+if __name__ == "__main__":
+    judge()
@@ -0,0 +1,34 @@
+#include "minilibc.h"
+
+// 用 -O2 编译：hot/cold 属性的函数分别进入 .text.hot、.text.unlikely，main 进入 .text.startup；
+// 含指针的只读表 names 进入 .data.rel.ro，可写的 counter 进入 .data
+static const char* const names[] = { "zero", "one", "two" };
+int counter = 5;
+
+__attribute__((noinline, cold)) int fail(int code)
+{
+    printf("error %d\n", code);
+    return -code;
+}
+
+__attribute__((noinline)) int helper(int x)
+{
+    return x * 7 + counter;
+}
+
+__attribute__((noinline, hot)) int fast_path(int x)
+{
+    if (x < 0)
+        return fail(x);
+    return helper(x) + (int)strlen(names[x % 3]);
+}
+
+int main()
+{
+    int sum = 0;
+    for (int i = 0; i < 10; i++)
+        sum += fast_path(i);
+    printf("sum: %d\n", sum);
+    printf("cold: %d\n", fail(3));
+    return 0;
+}
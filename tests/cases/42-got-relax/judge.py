@@ -0,0 +1,54 @@
+#!/usr/bin/env python3
+"""
+GOT/PLT 松弛测试 Judge：检查可执行文件的 GOT 与代码
+- 只有共享库提供的 ext_scale、ext_bias 有动态重定位，本模块内的函数和变量没有
+- GOT 共 3 个槽：ext_scale、ext_bias，以及 cmp 指令无法松弛而保留的 counter
+- mov/call/jmp *GOTPCREL 被改写：出现 addr32 call 与 jmp + nop，只剩 ext_scale 的一个 PLT 桩经过 GOT 跳转
+"""
+import json
+import os
+import re
+import subprocess
+import sys
+
+SCRIPT_DIR = os.path.dirname(__file__)
+ROOT_DIR = os.path.abspath(os.path.join(SCRIPT_DIR, "..", ".."))
+if ROOT_DIR not in sys.path:
+    sys.path.append(ROOT_DIR)
+
+from common.fle_utils import extract_dynamic_relocs
+
+
+def result(success, message):
+    print(json.dumps({"success": success, "message": message}))
+
+
+def judge():
+    input_data = json.load(sys.stdin)
+    test_dir = input_data["test_dir"]
+    build_dir = os.path.join(test_dir, "build")
+    root_dir = os.path.abspath(os.path.join(test_dir, "..", "..", ".."))
+    program = os.path.join(build_dir, "program")
+
+    with open(program) as f:
+        exe = json.load(f)
+    symbols = sorted(r["symbol"] for r in extract_dynamic_relocs(exe))
+    if symbols != ["ext_bias", "ext_scale"]:
+        return result(False, f"Expected dynamic relocations only for ext_bias and ext_scale, found {symbols}")
+    got = [ph for ph in exe["phdrs"] if ph["name"] == ".got"]
+    if not got or got[0]["size"] != 3 * 8:
+        return result(False, f"Expected 3 GOT slots, found {got[0]['size'] // 8 if got else 0}")
+
+    text = subprocess.run([os.path.join(root_dir, "disasm"), program, ".text"], capture_output=True, text=True).stdout
+    if "addr32 call" not in text:
+        return result(False, "call *GOTPCREL was not relaxed to addr32 call")
+    if not re.search(r"e9 [0-9a-f ]+jmp .*\n[0-9a-f]+: 90 ", text):
+        return result(False, "jmp *GOTPCREL was not relaxed to jmp + nop")
+    indirect = re.findall(r"^[0-9a-f]+: ff (?:15|25) ", text, re.MULTILINE)
+    if len(indirect) != 1:
+        return result(False, f"Expected a single PLT stub jumping through the GOT, found {len(indirect)} indirect calls/jumps")
+    result(True, "PLT/GOT only for shared library symbols, local GOTPCREL relaxed")
+
+
+if __name__ == "__main__":
+    judge()
@@ -0,0 +1,7 @@
+// 共享库提供的函数与数据：可执行文件必须继续经过 PLT/GOT 引用它们
+int ext_bias = 100;
+
+int ext_scale(int x)
+{
+    return x * 3;
+}
@@ -0,0 +1,18 @@
+#include "minilibc.h"
+
+extern int ext_bias;
+extern int ext_scale(int x);
+extern int* counter_ptr(void);
+extern int twice_bump(int x);
+extern int is_counter(int* p);
+extern int bump_one(void);
+
+int main()
+{
+    int* p = counter_ptr();
+    printf("twice_bump: %d\n", twice_bump(5));
+    printf("bump_one: %d\n", bump_one());
+    printf("counter: %d %d\n", *p, is_counter(p));
+    printf("ext: %d\n", ext_scale(7) + ext_bias);
+    return 0;
+}
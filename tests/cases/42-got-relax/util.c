@@ -0,0 +1,33 @@
+// 用 -fPIC -fno-plt 编译：对全局变量和全局函数的访问都经过 GOT，
+// 链接进可执行文件后这些符号都在本模块内，ld 应当把它们松弛成直接引用
+int counter = 1;
+
+__attribute__((noinline)) int bump(int x)
+{
+    counter += x;
+    return counter;
+}
+
+int* counter_ptr(void)
+{
+    return &counter; // mov counter@GOTPCREL(%rip) -> lea
+}
+
+__attribute__((noinline)) int twice_bump(int x)
+{
+    bump(x); // call *bump@GOTPCREL(%rip) -> addr32 call
+    return bump(x);
+}
+
+int bump_one(void)
+{
+    return bump(1); // 尾调用 jmp *bump@GOTPCREL(%rip) -> jmp; nop
+}
+
+int is_counter(int* p)
+{
+    // cmp 无法改写成 lea，只能使用链接时填好的 GOT 槽
+    int same;
+    __asm__("cmpq counter@GOTPCREL(%%rip), %1\n\tsete %b0\n\tmovzbl %b0, %0" : "=r"(same) : "r"(p) : "cc");
+    return same;
+}
@@ -0,0 +1,53 @@
+#!/usr/bin/env python3
+"""
+节对齐测试 Judge：检查 vec.fo 的节头与链接结果
+- vec.fo 的 shdrs 记录了 addralign：.text 16、.rodata 32、.data 64、.bss 64
+- 排在奇数大小的节之后，scale_table、hot、bss_block 和 vec.c 中的函数仍按要求对齐
+- 代码段的填充是完整的 NOP 指令，反汇编中没有 (bad)
+"""
+import json
+import os
+import subprocess
+import sys
+
+EXPECTED_ALIGN = {".text": 16, ".rodata": 32, ".data": 64, ".bss": 64}
+SYMBOL_ALIGN = {"scale_table": 32, "hot": 64, "bss_block": 64, "scaled": 16, "sum_hot": 16}
+
+
+def result(success, message):
+    print(json.dumps({"success": success, "message": message}))
+
+
+def judge():
+    input_data = json.load(sys.stdin)
+    test_dir = input_data["test_dir"]
+    build_dir = os.path.join(test_dir, "build")
+    root_dir = os.path.abspath(os.path.join(test_dir, "..", "..", ".."))
+    program = os.path.join(build_dir, "program")
+
+    with open(os.path.join(build_dir, "vec.fo")) as f:
+        shdrs = {sh["name"]: sh.get("addralign", 1) for sh in json.load(f)["shdrs"]}
+    for name, align in EXPECTED_ALIGN.items():
+        if shdrs.get(name) != align:
+            return result(False, f"vec.fo {name} addralign is {shdrs.get(name)}, expected {align}")
+
+    out = subprocess.run([os.path.join(root_dir, "nm"), program], capture_output=True, text=True).stdout
+    symbols = {}
+    for line in out.splitlines():
+        parts = line.split()
+        if len(parts) == 3:
+            symbols[parts[2]] = int(parts[0], 16)
+    for name, align in SYMBOL_ALIGN.items():
+        if name not in symbols:
+            return result(False, f"{name} missing from nm output")
+        if symbols[name] % align:
+            return result(False, f"{name} at offset {symbols[name]:#x} is not {align}-byte aligned")
+
+    text = subprocess.run([os.path.join(root_dir, "disasm"), program, ".text"], capture_output=True, text=True).stdout
+    if "(bad)" in text:
+        return result(False, "Text padding does not decode as complete instructions")
+    result(True, "All sections keep their alignment")
+
+
+if __name__ == "__main__":
+    judge()
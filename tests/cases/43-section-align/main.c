@@ -0,0 +1,16 @@
+#include "minilibc.h"
+
+typedef float v4sf __attribute__((vector_size(16)));
+
+extern int odd(int x);
+extern v4sf scaled(v4sf x, int i);
+extern long sum_hot(void);
+
+int main()
+{
+    v4sf v = scaled((v4sf) { 1, 1, 2, 2 }, 1);
+    printf("odd: %d\n", odd(4));
+    printf("scaled: %d %d %d %d\n", (int)v[0], (int)v[1], (int)v[2], (int)v[3]);
+    printf("sum_hot: %d\n", (int)sum_hot());
+    return 0;
+}
@@ -0,0 +1,8 @@
+// 大小为奇数的节排在前面，打乱后续节的起始偏移
+char tag = 1;
+const char small_ro[3] = "ab";
+
+int odd(int x)
+{
+    return x + tag;
+}
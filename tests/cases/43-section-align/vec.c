@@ -0,0 +1,23 @@
+// 对齐要求高于默认值的节：32 字节对齐的向量常量、64 字节对齐的数据与 BSS
+typedef float v4sf __attribute__((vector_size(16)));
+
+const v4sf scale_table[2] __attribute__((aligned(32))) = { { 1, 2, 3, 4 }, { 5, 6, 7, 8 } };
+
+struct counters {
+    long v[8];
+} __attribute__((aligned(64)));
+
+struct counters hot = { { 1, 2, 3 } };
+__attribute__((aligned(64))) long bss_block[8];
+
+// mulps 的内存操作数必须 16 字节对齐，否则触发 #GP
+__attribute__((noinline)) v4sf scaled(v4sf x, int i)
+{
+    return x * scale_table[i];
+}
+
+__attribute__((noinline)) long sum_hot(void)
+{
+    bss_block[0] = hot.v[0] + hot.v[1] + hot.v[2];
+    return bss_block[0];
+}
@@ -0,0 +1,49 @@
+#!/usr/bin/env python3
+"""
+NOBITS .bss 测试 Judge：检查链接结果
+- .bss 程序头覆盖 256 MiB 缓冲区
+- .bss 节不含 🔢 字节行，只有符号行，输出文件远小于缓冲区
+- nm 仍能列出 .bss 中的符号
+"""
+import json
+import os
+import subprocess
+import sys
+
+BIG_SIZE = 256 << 20
+MAX_FILE_SIZE = 1 << 20
+
+
+def result(success, message):
+    print(json.dumps({"success": success, "message": message}))
+
+
+def judge():
+    input_data = json.load(sys.stdin)
+    test_dir = input_data["test_dir"]
+    build_dir = os.path.join(test_dir, "build")
+    root_dir = os.path.abspath(os.path.join(test_dir, "..", "..", ".."))
+    program = os.path.join(build_dir, "program")
+
+    size = os.path.getsize(program)
+    if size > MAX_FILE_SIZE:
+        return result(False, f"Output is {size} bytes, .bss bytes were written to the file")
+
+    with open(program) as f:
+        exe = json.load(f)
+    bss = [ph for ph in exe.get("phdrs", []) if ph["name"] == ".bss"]
+    if not bss or bss[0]["size"] < BIG_SIZE:
+        return result(False, f".bss segment does not cover the {BIG_SIZE} byte buffer")
+    if any(line.startswith("🔢") for line in exe.get(".bss", [])):
+        return result(False, ".bss section contains byte lines")
+
+    out = subprocess.run([os.path.join(root_dir, "nm"), program], capture_output=True, text=True).stdout
+    names = {line.split()[-1]: line.split()[1] for line in out.splitlines() if len(line.split()) == 3}
+    for name in ("touched",):
+        if names.get(name, "").lower() != "b":
+            return result(False, f"{name} is not listed as a .bss symbol by nm")
+    result(True, f".bss is size-only, output is {size} bytes")
+
+
+if __name__ == "__main__":
+    judge()
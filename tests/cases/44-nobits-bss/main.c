@@ -0,0 +1,22 @@
+#include "minilibc.h"
+
+// 256 MiB 的零初始化缓冲区，只占 .bss 的大小，不占输出文件
+#define BIG_SIZE (256L << 20)
+
+static char big_buffer[BIG_SIZE];
+long touched;
+
+int main(void)
+{
+    // 只访问首尾和少量页面，其余页面从未被写过
+    long zeros = 0;
+    for (long i = 0; i < BIG_SIZE; i += BIG_SIZE / 64) {
+        zeros += big_buffer[i] == 0;
+    }
+    big_buffer[0] = 1;
+    big_buffer[BIG_SIZE - 1] = 2;
+    touched = big_buffer[0] + big_buffer[BIG_SIZE - 1];
+    printf("zeros: %d\n", (int)zeros);
+    printf("touched: %d\n", (int)touched);
+    return 0;
+}
@@ -0,0 +1,56 @@
+#!/usr/bin/env python3
+"""
+紧凑段布局测试 Judge：检查 --pack-segments -z noseparate-code 的链接结果
+- 没有单独的 .got 段，GOT 的动态重定位位于 .data 中
+- .bss 紧跟在 .data 之后，不从新页开始
+- .rodata 与代码共用页，权限相同
+- 只有权限相同的段共用页，整个程序只占两页
+"""
+import json
+import os
+import sys
+
+PAGE = 4096
+
+
+def result(success, message):
+    print(json.dumps({"success": success, "message": message}))
+
+
+def pages(ph):
+    return set(range(ph["vaddr"] // PAGE, (ph["vaddr"] + ph["size"] + PAGE - 1) // PAGE))
+
+
+def judge():
+    input_data = json.load(sys.stdin)
+    build_dir = os.path.join(input_data["test_dir"], "build")
+    with open(os.path.join(build_dir, "program")) as f:
+        exe = json.load(f)
+
+    phdrs = {ph["name"]: ph for ph in exe["phdrs"] if ph["size"] > 0}
+    if ".got" in phdrs:
+        return result(False, ".got still has its own segment")
+    if not any(line.startswith("❓: .dynabs64(lib_base") for line in exe.get(".data", [])):
+        return result(False, "GOT slot of lib_base is not in .data")
+
+    text, rodata, data, bss = (phdrs.get(n) for n in (".text", ".rodata", ".data", ".bss"))
+    if not all((text, rodata, data, bss)):
+        return result(False, f"Missing segments: {sorted(phdrs)}")
+    if bss["vaddr"] >= (data["vaddr"] + data["size"] + PAGE - 1) // PAGE * PAGE:
+        return result(False, f".bss at {bss['vaddr']:#x} starts on a new page after .data")
+    if rodata["vaddr"] >= (text["vaddr"] + text["size"] + PAGE - 1) // PAGE * PAGE:
+        return result(False, f".rodata at {rodata['vaddr']:#x} starts on a new page after .text")
+
+    owners = {}
+    for ph in phdrs.values():
+        for page in pages(ph):
+            if page in owners and owners[page]["flags"] != ph["flags"]:
+                return result(False, f"{owners[page]['name']} and {ph['name']} share page {page * PAGE:#x} with different permissions")
+            owners[page] = ph
+    if len(owners) != 2:
+        return result(False, f"Program spans {len(owners)} pages, expected 2")
+    result(True, "Segments are packed into 2 pages")
+
+
+if __name__ == "__main__":
+    judge()
@@ -0,0 +1,7 @@
+// 共享库：提供一个数据符号和一个函数，可执行文件通过 GOT 访问它们
+int lib_base = 40;
+
+int lib_add(int x)
+{
+    return x + lib_base;
+}
@@ -0,0 +1,21 @@
+#include "minilibc.h"
+
+// .data、.got、.bss 都很小，紧凑布局下共用一页；.rodata 与代码共用一页
+extern int lib_base;
+int lib_add(int x);
+
+static const char banner[] = "packed";
+int counter = 1;
+long zeros[16];
+
+int main(void)
+{
+    long sum = 0;
+    for (int i = 0; i < 16; i++) {
+        sum += zeros[i];
+    }
+    zeros[15] = counter + lib_base;
+    counter = lib_add(counter);
+    printf("packed: %d %d %d %d\n", counter, (int)sum, (int)zeros[15], banner[0]);
+    return 0;
+}
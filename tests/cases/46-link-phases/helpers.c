@@ -0,0 +1,15 @@
+// 模块内互相调用的函数：直接 call，不分配 PLT 桩
+int helper_add(int a, int b)
+{
+    return a + b;
+}
+
+int helper_twice(int x)
+{
+    return helper_add(x, x);
+}
+
+int helper_chain(int x)
+{
+    return helper_twice(helper_add(x, 1));
+}
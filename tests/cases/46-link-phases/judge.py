@@ -0,0 +1,45 @@
+#!/usr/bin/env python3
+"""
+链接阶段测试 Judge：检查 ld --stats 的输出与链接结果
+- 标准错误列出全部链接阶段的耗时
+- 只有共享库提供的 lib_square 有 PLT 桩和 GOT 槽，模块内的函数没有
+- 动态重定位只有 lib_square 的 GOT 槽一条
+"""
+import json
+import os
+import re
+import sys
+
+PHASES = ["input scan", "symbol resolution", "section selection", "synthetic sections", "layout", "relocation", "output", "total"]
+
+
+def result(success, message):
+    print(json.dumps({"success": success, "message": message}))
+
+
+def judge():
+    input_data = json.load(sys.stdin)
+    build_dir = os.path.join(input_data["test_dir"], "build")
+    stderr = input_data.get("stderr", "")
+
+    for phase in PHASES:
+        if not re.search(rf"^\s*{phase}\s+[0-9.]+ ms$", stderr, re.MULTILINE):
+            return result(False, f"Phase '{phase}' missing from ld --stats output")
+    m = re.search(r"PLT stubs: (\d+), GOT slots: (\d+) \((\d+) filled at link time\), dynamic relocations: (\d+)", stderr)
+    if not m:
+        return result(False, "PLT/GOT counts missing from ld --stats output")
+    plt, got, _, dyn = map(int, m.groups())
+    if (plt, got, dyn) != (1, 1, 1):
+        return result(False, f"Expected 1 PLT stub, 1 GOT slot and 1 dynamic relocation, got {plt}, {got}, {dyn}")
+
+    with open(os.path.join(build_dir, "program")) as f:
+        exe = json.load(f)
+    dyn_symbols = [line for lines in exe.values() if isinstance(lines, list) for line in lines
+                   if isinstance(line, str) and line.startswith("❓: .dyn")]
+    if len(dyn_symbols) != 1 or "lib_square" not in dyn_symbols[0]:
+        return result(False, f"Unexpected dynamic relocations: {dyn_symbols}")
+    result(True, "All phases reported, only lib_square goes through the PLT")
+
+
+if __name__ == "__main__":
+    judge()
@@ -0,0 +1,5 @@
+// 共享库只提供一个函数，可执行文件中只有它需要 PLT 桩和 GOT 槽
+int lib_square(int x)
+{
+    return x * x;
+}
@@ -0,0 +1,16 @@
+#include "minilibc.h"
+
+int helper_add(int a, int b);
+int helper_twice(int x);
+int helper_chain(int x);
+int lib_square(int x);
+
+int main(void)
+{
+    int a = helper_add(2, 3);
+    int b = helper_twice(a);
+    int c = helper_chain(b);
+    printf("helpers: %d %d %d\n", a, b, c);
+    printf("square: %d\n", lib_square(c));
+    return 0;
+}
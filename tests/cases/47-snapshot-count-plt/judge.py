@@ -0,0 +1,80 @@
+#!/usr/bin/env python3
+"""
+快照 + PLT 计数测试 Judge：
+- 同一个可执行文件搭配两个内容不同的 libcount.so，各自留下一份快照，互不覆盖
+- 两种依赖各自从快照启动，并且 --count-plt 统计的调用次数准确
+"""
+import json
+import os
+import re
+import shutil
+import subprocess
+import sys
+
+CALLS = 10
+
+
+def result(success, message):
+    print(json.dumps({"success": success, "message": message}))
+
+
+def run_exec(root_dir, build_dir, lib_dir, snap_dir, extra):
+    env = dict(os.environ, FLE_LIBRARY_PATH=lib_dir, FLE_DEBUG="statistics")
+    return subprocess.run(
+        [os.path.join(root_dir, "exec"), "--snapshot-cache", snap_dir, *extra, os.path.join(build_dir, "program")],
+        capture_output=True,
+        text=True,
+        env=env,
+        timeout=30,
+    )
+
+
+def snapshot_hits(stderr):
+    m = re.search(r"\bsnapshot\s+[0-9.]+ ms\s+(\d+)\s*$", stderr, re.M)
+    return int(m.group(1)) if m else None
+
+
+def judge():
+    input_data = json.load(sys.stdin)
+    test_dir = input_data["test_dir"]
+    build_dir = os.path.join(test_dir, "build")
+    root_dir = os.path.abspath(os.path.join(test_dir, "..", "..", ".."))
+
+    snap_dir = os.path.join(build_dir, "snapshots")
+    alt_dir = os.path.join(build_dir, "alt")
+    shutil.rmtree(snap_dir, ignore_errors=True)
+    os.makedirs(alt_dir, exist_ok=True)
+    shutil.copyfile(os.path.join(build_dir, "libcount_alt.so"), os.path.join(alt_dir, "libcount.so"))
+
+    variants = [(build_dir, CALLS), (alt_dir, CALLS * 2)]
+    for lib_dir, total in variants:
+        proc = run_exec(root_dir, build_dir, lib_dir, snap_dir, [])
+        if proc.returncode != 0:
+            return result(False, f"exec exited with {proc.returncode}: {proc.stderr}")
+        if proc.stdout != f"sum: {total}\n":
+            return result(False, f"Unexpected program output: {proc.stdout!r}")
+
+    snaps = [f for f in os.listdir(snap_dir) if f.endswith(".snap")]
+    if len(snaps) != 2:
+        return result(False, f"Expected one snapshot per dependency set, found {snaps}")
+
+    for lib_dir, total in variants:
+        proc = run_exec(root_dir, build_dir, lib_dir, snap_dir, ["--count-plt"])
+        if proc.returncode != 0:
+            return result(False, f"exec --count-plt exited with {proc.returncode}: {proc.stderr}")
+        if proc.stdout != f"sum: {total}\n":
+            return result(False, f"Unexpected program output: {proc.stdout!r}")
+        if snapshot_hits(proc.stderr) != 1:
+            return result(False, f"Run with {lib_dir} did not start from its snapshot: {proc.stderr}")
+        counts = {}
+        for line in proc.stderr.splitlines():
+            m = re.match(r"^\s+(\d+)\s+(\S.*)$", line)
+            if m:
+                counts[m.group(2)] = int(m.group(1))
+        if counts.get("bump") != CALLS:
+            return result(False, f"Expected {CALLS} calls to bump, got {counts.get('bump')}: {proc.stderr}")
+    result(True, "Each dependency set has its own snapshot and PLT counts are exact")
+
+
+if __name__ == "__main__":
+    judge()
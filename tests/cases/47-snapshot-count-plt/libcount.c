@@ -0,0 +1,5 @@
+// 快照与 --count-plt 测试：启动时加载的库，bump 在循环中被反复调用
+int bump(int x)
+{
+    return x + 1;
+}
@@ -0,0 +1,5 @@
+// 同名库的另一个版本：内容不同，快照必须按依赖的哈希分开缓存
+int bump(int x)
+{
+    return x + 2;
+}
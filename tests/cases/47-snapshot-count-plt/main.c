@@ -0,0 +1,14 @@
+// 从快照启动后仍然要能统计 PLT 调用次数
+#include "minilibc.h"
+
+extern int bump(int x);
+
+int main()
+{
+    int sum = 0;
+    for (int i = 0; i < 10; i++) {
+        sum = bump(sum);
+    }
+    printf("sum: %d\n", sum);
+    return 0;
+}
@@ -0,0 +1,11 @@
+#include "minilibc.h"
+
+extern int word_starts_with_w(void);
+extern int big_is_100000(void);
+extern int probe_labels(void);
+
+int main()
+{
+    printf("%d %d %d\n", word_starts_with_w(), big_is_100000(), probe_labels());
+    return 0;
+}
@@ -0,0 +1,9 @@
+// 最先链接的目标文件：与后面的文件有相同的字符串和常量，合并后保留的是这里的副本。
+// 每个池里再放一项独有的内容，使后面文件中各项的相对位置在合并后发生变化
+__asm__(".section .rodata.str1.1,\"aMS\",@progbits,1\n"
+        ".string \"tail\"\n"
+        ".string \"xyz\"\n"
+        ".section .rodata.cst4,\"aM\",@progbits,4\n"
+        ".long 7\n"
+        ".long 8\n"
+        ".text\n");
@@ -0,0 +1,15 @@
+// 经标号引用的合并项：汇编器保留标号，加数中的 -5、-8 偏置原样保留即可
+__asm__(".section .rodata.str1.1,\"aMS\",@progbits,1\n"
+        "probe_xyz: .string \"xyz\"\n"
+        ".section .rodata.cst4,\"aM\",@progbits,4\n"
+        "probe_eight: .long 8\n"
+        "probe_big: .long 250000\n"
+        ".text\n"
+        ".globl probe_labels\n"
+        "probe_labels:\n"
+        "  xorl %eax, %eax\n"
+        "  cmpb $0x78, probe_xyz(%rip)\n"
+        "  jne 1f\n"
+        "  cmpl $250000, probe_big(%rip)\n"
+        "  sete %al\n"
+        "1: ret\n");
@@ -0,0 +1,21 @@
+// 以"节符号 + 偏移"做 PC 相对引用，cmp 指令在位移之后还有立即数：
+// 加数中的偏置是 -5 和 -8，而不是 -4
+__asm__(".section .rodata.str1.1,\"aMS\",@progbits,1\n"
+        ".string \"tail\"\n"
+        ".string \"word\"\n"
+        ".section .rodata.cst4,\"aM\",@progbits,4\n"
+        ".long 7\n"
+        ".long 100000\n"
+        ".text\n"
+        ".globl word_starts_with_w\n"
+        "word_starts_with_w:\n"
+        "  xorl %eax, %eax\n"
+        "  cmpb $0x77, .rodata.str1.1+5(%rip)\n"
+        "  sete %al\n"
+        "  ret\n"
+        ".globl big_is_100000\n"
+        "big_is_100000:\n"
+        "  xorl %eax, %eax\n"
+        "  cmpl $100000, .rodata.cst4+4(%rip)\n"
+        "  sete %al\n"
+        "  ret\n");
@@ -0,0 +1,21 @@
+// 静态变量和静态函数经普通 GOTPCREL 取址（push 不能松弛，必须使用 GOT 槽）。
+// b.c 中有同名的静态变量，共享库中有同名的函数 foo，它们各自需要独立的槽
+__attribute__((used)) static int value = 10;
+__attribute__((used)) static int foo(void)
+{
+    return 1;
+}
+
+int a_value(void)
+{
+    int* p;
+    __asm__("pushq value@GOTPCREL(%%rip)\n\tpopq %0" : "=r"(p));
+    return *p;
+}
+
+int a_call(void)
+{
+    int (*fn)(void);
+    __asm__("pushq foo@GOTPCREL(%%rip)\n\tpopq %0" : "=r"(fn));
+    return fn();
+}
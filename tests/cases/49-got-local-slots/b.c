@@ -0,0 +1,16 @@
+// 与 a.c 同名的静态变量；foo 调用的是共享库中的函数，经 PLT 到达
+__attribute__((used)) static int value = 20;
+
+extern int foo(void);
+
+int b_value(void)
+{
+    int* p;
+    __asm__("pushq value@GOTPCREL(%%rip)\n\tpopq %0" : "=r"(p));
+    return *p;
+}
+
+int b_call(void)
+{
+    return foo();
+}
@@ -0,0 +1,5 @@
+// 共享库导出的 foo：与 a.c 中的静态函数同名
+int foo(void)
+{
+    return 100;
+}
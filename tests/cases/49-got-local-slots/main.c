@@ -0,0 +1,12 @@
+#include "minilibc.h"
+
+extern int a_value(void);
+extern int b_value(void);
+extern int a_call(void);
+extern int b_call(void);
+
+int main()
+{
+    printf("%d %d %d %d\n", a_value(), b_value(), a_call(), b_call());
+    return 0;
+}
@@ -144,6 +144,37 @@ int vsprintf(char* buf, const char* fmt, va_list ap)
     return p - buf;
 }
 
+// 运行时加载接口：由加载器 (exec) 在重定位后填写，布局需与 exec.cpp 中的 FleLoaderApi 一致
+struct fle_loader_api {
+    unsigned long version;
+    void* (*dlopen)(const char* name);
+    void* (*dlsym)(void* handle, const char* name);
+    int (*dlclose)(void* handle);
+    const char* (*dlerror)(void);
+};
+
+struct fle_loader_api* __fle_loader_api;
+
+void* fle_dlopen(const char* name)
+{
+    return __fle_loader_api ? __fle_loader_api->dlopen(name) : NULL;
+}
+
+void* fle_dlsym(void* handle, const char* name)
+{
+    return __fle_loader_api ? __fle_loader_api->dlsym(handle, name) : NULL;
+}
+
+int fle_dlclose(void* handle)
+{
+    return __fle_loader_api ? __fle_loader_api->dlclose(handle) : -1;
+}
+
+const char* fle_dlerror(void)
+{
+    return __fle_loader_api ? __fle_loader_api->dlerror() : "no runtime loader";
+}
+
 int main();
 
 // libc provides the "_start".
@@ -16,4 +16,10 @@ int sprintf(char* buf, const char* fmt, ...);
 int vsprintf(char* buf, const char* fmt, va_list ap);
 int printf(const char* fmt, ...);
 
+// 运行时加载共享库 (由 exec 提供实现)
+void* fle_dlopen(const char* name);
+void* fle_dlsym(void* handle, const char* name);
+int fle_dlclose(void* handle);
+const char* fle_dlerror(void);
+
 #endif // __MINILIBC_H__